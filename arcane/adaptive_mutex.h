@@ -0,0 +1,104 @@
+#ifndef ARCANE_ADAPTIVE_MUTEX_H
+#define ARCANE_ADAPTIVE_MUTEX_H
+
+#include <stdint.h>
+#include <atomic>
+#include <algorithm>
+
+#include <arcane/futex.h>
+#include <arcane/thread_utils.h>
+
+namespace arcane {
+
+// waits between two spins of an AdaptiveMutex, backoff grows exponentially
+struct CpuRelaxSpinWait {
+    static void Wait(int32_t backoff) {
+        for (int32_t i = 0; i < backoff; ++i) {
+            CpuRelax();
+        }
+    }
+};
+
+// Spins a while before sleeping on a futex, for critical sections short
+// enough that the holder usually leaves before a context switch would pay
+// off. The spin budget follows how long acquisitions took recently, in the
+// way of glibc's PTHREAD_MUTEX_ADAPTIVE_NP: waiters spinning in vain lower
+// it towards parking right away. Spinning reads the word before trying to
+// take it (test and test and set) and backs off exponentially, so waiters
+// do not keep stealing the cache line from the holder. The lock has a cache
+// line to itself to keep it clear of neighbouring data.
+template <typename SpinWait = CpuRelaxSpinWait>
+class alignas(64) AdaptiveMutex {
+public:
+    // spins of the first contended acquisition, and the most ever tried
+    static constexpr const int32_t kMinSpins = 10;
+    static constexpr const int32_t kMaxSpins = 100;
+
+    AdaptiveMutex()
+        : state_(kUnlocked),
+          spins_(0) {
+    }
+
+    AdaptiveMutex(const AdaptiveMutex&) = delete;
+    AdaptiveMutex& operator=(const AdaptiveMutex&) = delete;
+
+    void Lock() {
+        if (TryLock()) {
+            return;
+        }
+        int32_t spins = spins_.load(std::memory_order_relaxed);
+        int32_t max_spins = std::min(spins * 2 + kMinSpins, kMaxSpins);
+        int32_t count = 0;
+        int32_t backoff = 1;
+        bool acquired = false;
+        while (!acquired && count < max_spins) {
+            ++count;
+            SpinWait::Wait(backoff);
+            backoff = std::min(backoff * 2, kMaxBackoff);
+            acquired = state_.load(std::memory_order_relaxed) == kUnlocked && TryLock();
+        }
+        spins_.store(spins + (count - spins) / 8, std::memory_order_relaxed);
+        // taken on the last spin the lock is ours, parking would wait on it
+        if (!acquired) {
+            Park();
+        }
+    }
+
+    bool TryLock() {
+        uint32_t state = kUnlocked;
+        return state_.compare_exchange_strong(state, kLocked, std::memory_order_acquire);
+    }
+
+    void Unlock() {
+        if (state_.exchange(kUnlocked, std::memory_order_release) == kContended) {
+            FutexWake(&state_, 1);
+        }
+    }
+
+    bool IsLocked() const {
+        return state_.load(std::memory_order_relaxed) != kUnlocked;
+    }
+
+private:
+    static constexpr const uint32_t kUnlocked = 0;
+    static constexpr const uint32_t kLocked = 1;
+    static constexpr const uint32_t kContended = 2;
+
+    static constexpr const int32_t kMaxBackoff = 16;
+
+    void Park() {
+        uint32_t state = state_.exchange(kContended, std::memory_order_acquire);
+        while (state != kUnlocked) {
+            FutexWait(&state_, kContended);
+            state = state_.exchange(kContended, std::memory_order_acquire);
+        }
+    }
+
+    std::atomic<uint32_t> state_;
+    // running estimate of the spins an acquisition needs
+    std::atomic<int32_t> spins_;
+};
+
+} // namespace arcane
+
+#endif
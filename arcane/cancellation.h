@@ -0,0 +1,59 @@
+#ifndef ARCANE_CANCELLATION_H
+#define ARCANE_CANCELLATION_H
+
+#include <atomic>
+#include <memory>
+#include <utility>
+
+namespace arcane {
+
+namespace detail {
+
+class CancellationState {
+public:
+    CancellationState()
+        : cancelled_(false) {
+    }
+
+    bool IsCancelled() const {
+        return cancelled_.load(std::memory_order_acquire);
+    }
+
+    void Cancel() {
+        cancelled_.store(true, std::memory_order_release);
+    }
+
+private:
+    std::atomic<bool> cancelled_;
+};
+
+} // namespace detail
+
+// Shared flag telling work that its result is no longer wanted. Copies
+// refer to the same flag. Futures skip their task if it is cancelled before
+// the task started, a running task may poll IsCancelled() to stop early.
+class CancellationToken {
+public:
+    CancellationToken()
+        : state_(std::make_shared<detail::CancellationState>()) {
+    }
+
+    explicit CancellationToken(std::shared_ptr<detail::CancellationState> state)
+        : state_(std::move(state)) {
+    }
+
+    bool IsCancelled() const {
+        return state_->IsCancelled();
+    }
+
+    void Cancel() const {
+        state_->Cancel();
+    }
+
+private:
+    std::shared_ptr<detail::CancellationState> state_;
+};
+
+} // namespace arcane
+
+#endif
@@ -0,0 +1,428 @@
+#ifndef ARCANE_CHANNEL_H
+#define ARCANE_CHANNEL_H
+
+#include <stdint.h>
+#include <atomic>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <optional>
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+
+#include <arcane/mutex.h>
+#include <arcane/condition.h>
+#include <arcane/lock_guard.h>
+#include <arcane/futex.h>
+
+namespace arcane {
+
+class Selector;
+
+namespace detail {
+
+// a blocked Select, woken by every channel it watches on any change
+class SelectWaiter {
+public:
+    SelectWaiter()
+        : sequence_(0) {
+    }
+
+    uint32_t Sequence() const {
+        return sequence_.load(std::memory_order_acquire);
+    }
+
+    void Notify() {
+        sequence_.fetch_add(1, std::memory_order_release);
+        FutexWake(&sequence_, 1);
+    }
+
+    // returns once Notify was called after sequence was read
+    void Wait(uint32_t sequence) {
+        while (sequence_.load(std::memory_order_acquire) == sequence) {
+            FutexWait(&sequence_, sequence);
+        }
+    }
+
+private:
+    std::atomic<uint32_t> sequence_;
+};
+
+enum class ChannelStatus {
+    kOk,
+    // full for a send, empty for a receive
+    kWouldBlock,
+    kClosed,
+};
+
+} // namespace detail
+
+// Queue between pipeline stages. A bounded channel blocks senders while
+// full, so a slow stage holds back the ones feeding it instead of letting
+// its input grow; capacity 0 makes the channel unbounded. After Close no
+// more values are accepted, receivers drain what is left and then fail.
+// T may be move-only. Several channels are waited on at once with a
+// Selector.
+//
+// Blocking calls park the calling thread, stages running on a ThreadPool
+// need one thread each for as long as they block.
+template <typename T, typename Lock = Mutex>
+class Channel {
+public:
+    explicit Channel(size_t capacity = 0)
+        : capacity_(capacity),
+          closed_(false),
+          mutex_(),
+          not_empty_(mutex_),
+          not_full_(mutex_) {
+    }
+
+    Channel(const Channel&) = delete;
+    Channel& operator=(const Channel&) = delete;
+
+    // blocks while full, returns false (dropping value) once closed
+    bool Send(T value) {
+        LockGuard<Lock> guard(mutex_);
+        while (!closed_ && Full()) {
+            not_full_.Wait();
+        }
+        if (closed_) {
+            return false;
+        }
+        PushLocked(std::move(value));
+        return true;
+    }
+
+    // value is only moved from if it was sent
+    bool TrySend(T&& value) {
+        std::optional<T> slot(std::move(value));
+        if (TryPut(slot) == detail::ChannelStatus::kOk) {
+            return true;
+        }
+        value = std::move(*slot);
+        return false;
+    }
+
+    bool TrySend(const T& value) {
+        std::optional<T> slot(value);
+        return TryPut(slot) == detail::ChannelStatus::kOk;
+    }
+
+    // blocks while empty, returns false once closed and drained
+    bool Recv(T& value) {
+        LockGuard<Lock> guard(mutex_);
+        while (!closed_ && queue_.empty()) {
+            not_empty_.Wait();
+        }
+        if (queue_.empty()) {
+            return false;
+        }
+        value = PopLocked();
+        return true;
+    }
+
+    bool TryRecv(T& value) {
+        std::optional<T> slot;
+        if (TryTake(slot) == detail::ChannelStatus::kOk) {
+            value = std::move(*slot);
+            return true;
+        }
+        return false;
+    }
+
+    void Close() {
+        LockGuard<Lock> guard(mutex_);
+        closed_ = true;
+        not_empty_.NotifyAll();
+        not_full_.NotifyAll();
+        NotifySelectors();
+    }
+
+    bool IsClosed() const {
+        LockGuard<Lock> guard(mutex_);
+        return closed_;
+    }
+
+    size_t Size() const {
+        LockGuard<Lock> guard(mutex_);
+        return queue_.size();
+    }
+
+    size_t Capacity() const {
+        return capacity_;
+    }
+
+private:
+    friend class Selector;
+
+    bool Full() const {
+        return capacity_ != 0 && queue_.size() >= capacity_;
+    }
+
+    void PushLocked(T&& value) {
+        queue_.push_back(std::move(value));
+        not_empty_.Notify();
+        NotifySelectors();
+    }
+
+    T PopLocked() {
+        T value(std::move(queue_.front()));
+        queue_.pop_front();
+        not_full_.Notify();
+        NotifySelectors();
+        return value;
+    }
+
+    // slot is emptied if the value was sent
+    detail::ChannelStatus TryPut(std::optional<T>& slot) {
+        LockGuard<Lock> guard(mutex_);
+        if (closed_) {
+            return detail::ChannelStatus::kClosed;
+        }
+        if (Full()) {
+            return detail::ChannelStatus::kWouldBlock;
+        }
+        PushLocked(std::move(*slot));
+        slot.reset();
+        return detail::ChannelStatus::kOk;
+    }
+
+    detail::ChannelStatus TryTake(std::optional<T>& slot) {
+        LockGuard<Lock> guard(mutex_);
+        if (queue_.empty()) {
+            return closed_ ? detail::ChannelStatus::kClosed : detail::ChannelStatus::kWouldBlock;
+        }
+        slot.emplace(PopLocked());
+        return detail::ChannelStatus::kOk;
+    }
+
+    void AddSelector(detail::SelectWaiter* waiter) {
+        LockGuard<Lock> guard(mutex_);
+        selectors_.push_back(waiter);
+    }
+
+    void RemoveSelector(detail::SelectWaiter* waiter) {
+        LockGuard<Lock> guard(mutex_);
+        selectors_.erase(std::find(selectors_.begin(), selectors_.end(), waiter));
+    }
+
+    void NotifySelectors() {
+        for (detail::SelectWaiter* waiter : selectors_) {
+            waiter->Notify();
+        }
+    }
+
+    const size_t capacity_;
+    bool closed_;
+    mutable Lock mutex_;
+    typename ConditionOf<Lock>::type not_empty_;
+    typename ConditionOf<Lock>::type not_full_;
+    std::deque<T> queue_;
+    std::vector<detail::SelectWaiter*> selectors_;
+};
+
+// Waits on several channels at once, like Go's select:
+//     Selector selector;
+//     selector.OnRecv(points, [](Point&& p) { ... })
+//             .OnRecv(control, [](Command&& c) { ... });
+//     while (selector.Select() != Selector::kAllClosed) {
+//     }
+// Every call runs the handler of exactly one ready case. Ready cases are
+// tried round robin so that a busy channel does not starve the others. A
+// receive case is done once its channel is closed and drained, a send
+// case once its value went out or its channel is closed.
+class Selector {
+public:
+    static constexpr const int kAllClosed = -1;
+    static constexpr const int kNotReady = -2;
+
+    Selector()
+        : next_(0) {
+    }
+
+    Selector(const Selector&) = delete;
+    Selector& operator=(const Selector&) = delete;
+
+    // f(T&&) gets the received value
+    template <typename T, typename Lock, typename F>
+    Selector& OnRecv(Channel<T, Lock>& channel, F&& f) {
+        cases_.emplace_back(new RecvCase<T, Lock, typename std::decay<F>::type>(
+                channel, std::forward<F>(f)));
+        return *this;
+    }
+
+    // f() runs once value was sent
+    template <typename T, typename Lock, typename F>
+    Selector& OnSend(Channel<T, Lock>& channel, T value, F&& f) {
+        cases_.emplace_back(new SendCase<T, Lock, typename std::decay<F>::type>(
+                channel, std::move(value), std::forward<F>(f)));
+        return *this;
+    }
+
+    // blocks until a case ran and returns its index in the order the cases
+    // were added, or kAllClosed if no case can ever run again
+    int Select() {
+        while (true) {
+            uint32_t sequence = waiter_.Sequence();
+            int index = TrySelect();
+            if (index != kNotReady) {
+                return index;
+            }
+            // registered before the cases are tried again, a change after
+            // that bumps the sequence and the wait returns right away
+            for (auto& c : cases_) {
+                if (!c->Done()) {
+                    c->Register(&waiter_);
+                }
+            }
+            index = TrySelect();
+            if (index == kNotReady) {
+                waiter_.Wait(sequence);
+            }
+            for (auto& c : cases_) {
+                c->Unregister(&waiter_);
+            }
+            if (index != kNotReady) {
+                return index;
+            }
+        }
+    }
+
+    // like Select, returns kNotReady instead of blocking
+    int TrySelect() {
+        size_t num = cases_.size();
+        bool alive = false;
+        for (size_t i = 0; i < num; ++i) {
+            size_t index = (next_ + i) % num;
+            Case& c = *cases_[index];
+            if (c.Done()) {
+                continue;
+            }
+            if (c.TryRun()) {
+                next_ = index + 1;
+                return static_cast<int>(index);
+            }
+            alive = alive || !c.Done();
+        }
+        return alive ? kNotReady : kAllClosed;
+    }
+
+private:
+    class Case {
+    public:
+        Case()
+            : done_(false),
+              registered_(false) {
+        }
+
+        virtual ~Case() {
+        }
+
+        bool Done() const {
+            return done_;
+        }
+
+        // returns true if the handler ran
+        virtual bool TryRun() = 0;
+
+        void Register(detail::SelectWaiter* waiter) {
+            DoRegister(waiter);
+            registered_ = true;
+        }
+
+        void Unregister(detail::SelectWaiter* waiter) {
+            if (registered_) {
+                DoUnregister(waiter);
+                registered_ = false;
+            }
+        }
+
+    protected:
+        virtual void DoRegister(detail::SelectWaiter* waiter) = 0;
+        virtual void DoUnregister(detail::SelectWaiter* waiter) = 0;
+
+        bool done_;
+
+    private:
+        bool registered_;
+    };
+
+    template <typename T, typename Lock, typename F>
+    class RecvCase : public Case {
+    public:
+        template <typename Func>
+        RecvCase(Channel<T, Lock>& channel, Func&& f)
+            : channel_(channel),
+              f_(std::forward<Func>(f)) {
+        }
+
+        bool TryRun() override {
+            std::optional<T> value;
+            detail::ChannelStatus status = channel_.TryTake(value);
+            if (status == detail::ChannelStatus::kOk) {
+                f_(std::move(*value));
+                return true;
+            }
+            done_ = status == detail::ChannelStatus::kClosed;
+            return false;
+        }
+
+    protected:
+        void DoRegister(detail::SelectWaiter* waiter) override {
+            channel_.AddSelector(waiter);
+        }
+
+        void DoUnregister(detail::SelectWaiter* waiter) override {
+            channel_.RemoveSelector(waiter);
+        }
+
+    private:
+        Channel<T, Lock>& channel_;
+        F f_;
+    };
+
+    template <typename T, typename Lock, typename F>
+    class SendCase : public Case {
+    public:
+        template <typename Func>
+        SendCase(Channel<T, Lock>& channel, T&& value, Func&& f)
+            : channel_(channel),
+              value_(std::move(value)),
+              f_(std::forward<Func>(f)) {
+        }
+
+        bool TryRun() override {
+            detail::ChannelStatus status = channel_.TryPut(value_);
+            if (status == detail::ChannelStatus::kOk) {
+                done_ = true;
+                f_();
+                return true;
+            }
+            done_ = status == detail::ChannelStatus::kClosed;
+            return false;
+        }
+
+    protected:
+        void DoRegister(detail::SelectWaiter* waiter) override {
+            channel_.AddSelector(waiter);
+        }
+
+        void DoUnregister(detail::SelectWaiter* waiter) override {
+            channel_.RemoveSelector(waiter);
+        }
+
+    private:
+        Channel<T, Lock>& channel_;
+        std::optional<T> value_;
+        F f_;
+    };
+
+    detail::SelectWaiter waiter_;
+    std::vector<std::unique_ptr<Case>> cases_;
+    size_t next_;
+};
+
+} // namespace arcane
+
+#endif
@@ -0,0 +1,161 @@
+#ifndef ARCANE_CLOCK_LRU_H
+#define ARCANE_CLOCK_LRU_H
+
+#include <stdint.h>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include <utility>
+
+#include <arcane/rwlock.h>
+#include <arcane/lock_guard.h>
+
+namespace arcane {
+
+// Thread safe cache evicting by CLOCK, an approximation of LRU: a hit only
+// sets the entry's reference bit, so Get and Exist run under the read lock
+// in parallel. Put and Delete take the write lock; when the cache is full
+// the hand sweeps the slots, clearing reference bits, and evicts the first
+// entry found unreferenced since the last sweep.
+//
+// Lock is RWLock or DistributedRWLock, the latter keeps readers on many
+// cores from bouncing the lock's cache line.
+template <
+    typename Key,
+    typename T,
+    typename Hash = std::hash<Key>,
+    typename Lock = RWLock>
+class ClockLru {
+public:
+    explicit ClockLru(size_t max_size)
+        : max_size_(max_size),
+          hand_(0),
+          slots_(new Slot[max_size]) {
+        map_.reserve(max_size);
+        free_.reserve(max_size);
+        for (size_t i = max_size; i > 0; --i) {
+            free_.push_back(i - 1);
+        }
+    }
+
+    ClockLru(const ClockLru&) = delete;
+    ClockLru& operator=(const ClockLru&) = delete;
+
+    // a cache of size 0 stores nothing
+    void Put(const Key& key, const T& data) {
+        if (max_size_ == 0) {
+            return;
+        }
+        WriteLockGuard<Lock> guard(lock_);
+        auto it = map_.find(key);
+        if (it != map_.end()) {
+            slots_[it->second].data = data;
+            Touch(slots_[it->second]);
+            return;
+        }
+        if (free_.empty()) {
+            Evict();
+        }
+        size_t slot = free_.back();
+        free_.pop_back();
+        slots_[slot].key = key;
+        slots_[slot].data = data;
+        slots_[slot].referenced.store(false, std::memory_order_relaxed);
+        map_.emplace(key, slot);
+    }
+
+    std::pair<T, bool> Get(const Key& key) {
+        auto res = std::make_pair(T(), false);
+        ReadLockGuard<Lock> guard(lock_);
+        auto it = map_.find(key);
+        if (it != map_.end()) {
+            Slot& slot = slots_[it->second];
+            res.first = slot.data;
+            res.second = true;
+            Touch(slot);
+        }
+        return res;
+    }
+
+    bool Exist(const Key& key) {
+        ReadLockGuard<Lock> guard(lock_);
+        auto it = map_.find(key);
+        if (it != map_.end()) {
+            Touch(slots_[it->second]);
+            return true;
+        }
+        return false;
+    }
+
+    void Delete(const Key& key) {
+        WriteLockGuard<Lock> guard(lock_);
+        auto it = map_.find(key);
+        if (it != map_.end()) {
+            // releases what the key and value hold now, not on reuse
+            Slot& slot = slots_[it->second];
+            slot.key = Key();
+            slot.data = T();
+            free_.push_back(it->second);
+            map_.erase(it);
+        }
+    }
+
+    bool Empty() const {
+        return Size() == 0;
+    }
+
+    size_t Size() const {
+        ReadLockGuard<Lock> guard(lock_);
+        return map_.size();
+    }
+
+private:
+    struct Slot {
+        Slot()
+            : referenced(false) {
+        }
+
+        Key key;
+        T data;
+        // set by hits under the read lock, cleared by the sweeping hand
+        std::atomic<bool> referenced;
+    };
+
+    // reads first, a hot entry's bit is already set and its cache line
+    // stays shared between the readers
+    static void Touch(Slot& slot) {
+        if (!slot.referenced.load(std::memory_order_relaxed)) {
+            slot.referenced.store(true, std::memory_order_relaxed);
+        }
+    }
+
+    // only called while full, every slot is used
+    void Evict() {
+        while (true) {
+            Slot& slot = slots_[hand_];
+            size_t victim = hand_;
+            hand_ = (hand_ + 1) % max_size_;
+            if (slot.referenced.load(std::memory_order_relaxed)) {
+                slot.referenced.store(false, std::memory_order_relaxed);
+                continue;
+            }
+            map_.erase(slot.key);
+            free_.push_back(victim);
+            return;
+        }
+    }
+
+    const size_t max_size_;
+    // next slot the sweep looks at
+    size_t hand_;
+    std::unique_ptr<Slot[]> slots_;
+    std::unordered_map<Key, size_t, Hash> map_;
+    std::vector<size_t> free_;
+    mutable Lock lock_;
+};
+
+} // namespace arcane
+
+#endif
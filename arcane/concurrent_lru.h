@@ -0,0 +1,113 @@
+#ifndef ARCANE_CONCURRENT_LRU_H
+#define ARCANE_CONCURRENT_LRU_H
+
+#include <stdint.h>
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <vector>
+#include <utility>
+
+#include <arcane/lru.h>
+#include <arcane/mutex.h>
+#include <arcane/lock_guard.h>
+
+namespace arcane {
+
+// Thread safe Lru split into shards by key hash, each with its own lock,
+// recency list and an equal part of the capacity, so that threads looking
+// up different keys rarely meet on a lock. Eviction is LRU within a shard,
+// which approximates global LRU once each shard holds many entries; more
+// shards mean less contention but a coarser approximation. Policy and
+// Hash come in the same order as for Lru.
+template <
+    typename Key,
+    typename T,
+    typename Policy = LruPolicy,
+    typename Hash = std::hash<Key>,
+    typename Lock = Mutex>
+class ConcurrentLru {
+public:
+    // at most max_size shards, the capacities add up to exactly max_size
+    explicit ConcurrentLru(size_t max_size, size_t num_shards = 16)
+        : hash_() {
+        num_shards = std::max<size_t>(1, std::min(num_shards, max_size));
+        shards_.reserve(num_shards);
+        for (size_t i = 0; i < num_shards; ++i) {
+            shards_.emplace_back(new Shard(max_size / num_shards + (i < max_size % num_shards ? 1 : 0)));
+        }
+    }
+
+    ConcurrentLru(const ConcurrentLru&) = delete;
+    ConcurrentLru& operator=(const ConcurrentLru&) = delete;
+
+    void Put(const Key& key, const T& data) {
+        Shard& shard = ShardOf(key);
+        LockGuard<Lock> guard(shard.mutex);
+        shard.lru.Put(key, data);
+    }
+
+    std::pair<T, bool> Get(const Key& key) {
+        Shard& shard = ShardOf(key);
+        LockGuard<Lock> guard(shard.mutex);
+        return shard.lru.Get(key);
+    }
+
+    bool Exist(const Key& key) {
+        Shard& shard = ShardOf(key);
+        LockGuard<Lock> guard(shard.mutex);
+        return shard.lru.Exist(key);
+    }
+
+    void Delete(const Key& key) {
+        Shard& shard = ShardOf(key);
+        LockGuard<Lock> guard(shard.mutex);
+        shard.lru.Delete(key);
+    }
+
+    // sums the shards one at a time, exact only while nobody writes
+    bool Empty() const {
+        return Size() == 0;
+    }
+
+    size_t Size() const {
+        size_t size = 0;
+        for (auto& shard : shards_) {
+            LockGuard<Lock> guard(shard->mutex);
+            size += shard->lru.Size();
+        }
+        return size;
+    }
+
+    size_t NumShards() const {
+        return shards_.size();
+    }
+
+private:
+    static constexpr const size_t kCacheLineSize = 64;
+
+    struct Shard {
+        explicit Shard(size_t max_size)
+            : lru(max_size) {
+        }
+
+        mutable Lock mutex;
+        Lru<Key, T, Policy, Hash> lru;
+        // keeps the lock of the next shard off this cache line
+        char padding[kCacheLineSize];
+    };
+
+    Shard& ShardOf(const Key& key) {
+        // std::hash of an integer is the integer itself, the multiply
+        // spreads sequential keys, the high bits feed the modulo
+        uint64_t hash = static_cast<uint64_t>(hash_(key)) * 0x9e3779b97f4a7c15ULL;
+        return *shards_[(hash >> 32) % shards_.size()];
+    }
+
+    Hash hash_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+};
+
+} // namespace arcane
+
+#endif
@@ -37,7 +37,7 @@ public:
         constexpr const int64_t kNanoSecondsPerSecond = 1e9;
         int64_t nanoseconds = microseconds * 1000 + t.tv_nsec;
         t.tv_sec += static_cast<time_t>(nanoseconds / kNanoSecondsPerSecond);
-        t.tv_nsec += static_cast<long>(nanoseconds % kNanoSecondsPerSecond);
+        t.tv_nsec = static_cast<long>(nanoseconds % kNanoSecondsPerSecond);
 
         Mutex::ConditionGuard guard(mutex_);
         return pthread_cond_timedwait(&cond_, mutex_.GetPthreadMutex(), &t) == ETIMEDOUT;
@@ -63,6 +63,16 @@ private:
     pthread_cond_t cond_;
 };
 
+// the condition variable working with a lock type, used by templates
+// taking the lock as a parameter
+template <typename Lock>
+struct ConditionOf;
+
+template <>
+struct ConditionOf<Mutex> {
+    using type = Condition;
+};
+
 } // namespace arcane
 
 #endif
@@ -0,0 +1,284 @@
+#ifndef ARCANE_COROUTINE_H
+#define ARCANE_COROUTINE_H
+
+#include <stdint.h>
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include <arcane/futex.h>
+#include <arcane/schedule_awaiter.h>
+
+namespace arcane {
+
+template <typename T = void>
+class Task;
+
+namespace detail {
+
+class TaskPromiseBase {
+public:
+    // resumes whoever awaits the task, by symmetric transfer so that long
+    // chains of tasks do not grow the stack
+    struct FinalAwaiter {
+        bool await_ready() const noexcept {
+            return false;
+        }
+
+        template <typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+            std::coroutine_handle<> continuation = handle.promise().continuation_;
+            return continuation ? continuation : std::noop_coroutine();
+        }
+
+        void await_resume() const noexcept {
+        }
+    };
+
+    std::suspend_always initial_suspend() const noexcept {
+        return {};
+    }
+
+    FinalAwaiter final_suspend() const noexcept {
+        return {};
+    }
+
+    void unhandled_exception() {
+        exception_ = std::current_exception();
+    }
+
+    void SetContinuation(std::coroutine_handle<> continuation) {
+        continuation_ = continuation;
+    }
+
+protected:
+    void RethrowIfFailed() {
+        if (exception_) {
+            std::rethrow_exception(exception_);
+        }
+    }
+
+private:
+    std::coroutine_handle<> continuation_;
+    std::exception_ptr exception_;
+};
+
+template <typename T>
+class TaskPromise : public TaskPromiseBase {
+public:
+    Task<T> get_return_object();
+
+    template <typename U>
+    void return_value(U&& value) {
+        value_.emplace(std::forward<U>(value));
+    }
+
+    T Result() {
+        RethrowIfFailed();
+        return std::move(*value_);
+    }
+
+private:
+    std::optional<T> value_;
+};
+
+template <>
+class TaskPromise<void> : public TaskPromiseBase {
+public:
+    Task<void> get_return_object();
+
+    void return_void() {
+    }
+
+    void Result() {
+        RethrowIfFailed();
+    }
+};
+
+} // namespace detail
+
+// Lazy coroutine returning T, it does not run until awaited, and resumes
+// the awaiting coroutine once done. Combined with co_await pool.Schedule()
+// and co_await future a chain of compute stages never blocks a thread.
+// Use SyncWait to get the result from a plain function.
+template <typename T>
+class Task {
+public:
+    using promise_type = detail::TaskPromise<T>;
+
+    class Awaiter {
+    public:
+        explicit Awaiter(std::coroutine_handle<promise_type> handle)
+            : handle_(handle) {
+        }
+
+        bool await_ready() const noexcept {
+            return handle_.done();
+        }
+
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+            handle_.promise().SetContinuation(awaiting);
+            return handle_;
+        }
+
+        T await_resume() {
+            return handle_.promise().Result();
+        }
+
+    private:
+        std::coroutine_handle<promise_type> handle_;
+    };
+
+    explicit Task(std::coroutine_handle<promise_type> handle)
+        : handle_(handle) {
+    }
+
+    Task(Task&& other) noexcept
+        : handle_(std::exchange(other.handle_, nullptr)) {
+    }
+
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            if (handle_) {
+                handle_.destroy();
+            }
+            handle_ = std::exchange(other.handle_, nullptr);
+        }
+        return *this;
+    }
+
+    ~Task() {
+        if (handle_) {
+            handle_.destroy();
+        }
+    }
+
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    Awaiter operator co_await() const noexcept {
+        return Awaiter(handle_);
+    }
+
+private:
+    std::coroutine_handle<promise_type> handle_;
+};
+
+namespace detail {
+
+template <typename T>
+Task<T> TaskPromise<T>::get_return_object() {
+    return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+}
+
+inline Task<void> TaskPromise<void>::get_return_object() {
+    return Task<void>(std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+}
+
+// coroutine driving SyncWait, it signals a futex once finished. The futex
+// word lives in the SyncWaitTask on the waiting thread's stack, not in the
+// frame: the waiter destroys the frame as soon as it sees the word set,
+// the wake after that must not touch the frame.
+class SyncWaitTask {
+public:
+    class promise_type {
+    public:
+        struct FinalAwaiter {
+            bool await_ready() const noexcept {
+                return false;
+            }
+
+            void await_suspend(std::coroutine_handle<promise_type> handle) const noexcept {
+                std::atomic<uint32_t>* done = handle.promise().done_;
+                done->store(1, std::memory_order_release);
+                FutexWake(done, 1);
+            }
+
+            void await_resume() const noexcept {
+            }
+        };
+
+        promise_type()
+            : done_(nullptr) {
+        }
+
+        SyncWaitTask get_return_object() {
+            return SyncWaitTask(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        std::suspend_always initial_suspend() const noexcept {
+            return {};
+        }
+
+        FinalAwaiter final_suspend() const noexcept {
+            return {};
+        }
+
+        void return_void() {
+        }
+
+        void unhandled_exception() {
+            exception_ = std::current_exception();
+        }
+
+    private:
+        friend class SyncWaitTask;
+
+        std::atomic<uint32_t>* done_;
+        std::exception_ptr exception_;
+    };
+
+    explicit SyncWaitTask(std::coroutine_handle<promise_type> handle)
+        : done_(0),
+          handle_(handle) {
+    }
+
+    ~SyncWaitTask() {
+        handle_.destroy();
+    }
+
+    SyncWaitTask(const SyncWaitTask&) = delete;
+    SyncWaitTask& operator=(const SyncWaitTask&) = delete;
+
+    void Run() {
+        handle_.promise().done_ = &done_;
+        handle_.resume();
+        while (done_.load(std::memory_order_acquire) == 0) {
+            FutexWait(&done_, 0);
+        }
+        if (handle_.promise().exception_) {
+            std::rethrow_exception(handle_.promise().exception_);
+        }
+    }
+
+private:
+    std::atomic<uint32_t> done_;
+    std::coroutine_handle<promise_type> handle_;
+};
+
+} // namespace detail
+
+// runs task and blocks the calling thread until it is done
+template <typename T>
+T SyncWait(Task<T> task) {
+    if constexpr (std::is_void_v<T>) {
+        auto waiter = [&task]() -> detail::SyncWaitTask {
+            co_await task;
+        };
+        waiter().Run();
+    } else {
+        std::optional<T> result;
+        auto waiter = [&task, &result]() -> detail::SyncWaitTask {
+            result.emplace(co_await task);
+        };
+        waiter().Run();
+        return std::move(*result);
+    }
+}
+
+} // namespace arcane
+
+#endif
@@ -0,0 +1,136 @@
+#ifndef ARCANE_DISTRIBUTED_RWLOCK_H
+#define ARCANE_DISTRIBUTED_RWLOCK_H
+
+#include <stdint.h>
+#include <limits.h>
+#include <sched.h>
+#include <atomic>
+#include <memory>
+#include <thread>
+
+#include <arcane/futex.h>
+#include <arcane/mutex.h>
+#include <arcane/thread_utils.h>
+
+namespace arcane {
+
+// Reader-writer lock for read-mostly data. Every thread counts itself in
+// one of a set of reader slots, each on its own cache line, so readers on
+// different cores share no written memory and read throughput grows with
+// the number of cores. The price is paid by writers: a writer raises a
+// flag turning new readers away, then waits until every slot drained.
+//
+// Writers are preferred, a thread must not take the read lock twice while
+// a writer may be waiting. Use with ReadLockGuard and WriteLockGuard.
+class DistributedRWLock {
+public:
+    // num_slots 0 picks one slot per hardware thread
+    explicit DistributedRWLock(size_t num_slots = 0)
+        : num_slots_(RoundUpToPowerOfTwo(num_slots ? num_slots : std::thread::hardware_concurrency())),
+          slots_(new Slot[num_slots_]),
+          writer_(kNoWriter) {
+    }
+
+    DistributedRWLock(const DistributedRWLock&) = delete;
+    DistributedRWLock& operator=(const DistributedRWLock&) = delete;
+
+    void ReadLock() {
+        std::atomic<int64_t>& readers = slots_[ThreadIndex() & (num_slots_ - 1)].readers;
+        while (true) {
+            // pairs with the flag raised in WriteLock, one of both sides
+            // sees the other
+            readers.fetch_add(1, std::memory_order_seq_cst);
+            if (writer_.load(std::memory_order_seq_cst) == kNoWriter) {
+                return;
+            }
+            readers.fetch_sub(1, std::memory_order_release);
+            WaitForWriter();
+        }
+    }
+
+    void ReadUnlock() {
+        slots_[ThreadIndex() & (num_slots_ - 1)].readers.fetch_sub(1, std::memory_order_release);
+    }
+
+    void WriteLock() {
+        writer_mutex_.Lock();
+        writer_.store(kWriter, std::memory_order_seq_cst);
+        for (size_t i = 0; i < num_slots_; ++i) {
+            int spins = 0;
+            while (slots_[i].readers.load(std::memory_order_seq_cst) != 0) {
+                if (++spins < kSpinsBeforeYield) {
+                    CpuRelax();
+                } else {
+                    sched_yield();
+                }
+            }
+        }
+    }
+
+    void WriteUnlock() {
+        if (writer_.exchange(kNoWriter, std::memory_order_release) == kWriterWithWaiters) {
+            FutexWake(&writer_, INT_MAX);
+        }
+        writer_mutex_.Unlock();
+    }
+
+    size_t NumSlots() const {
+        return num_slots_;
+    }
+
+private:
+    static constexpr const size_t kCacheLineSize = 64;
+    static constexpr const int kSpinsBeforeYield = 128;
+
+    static constexpr const uint32_t kNoWriter = 0;
+    static constexpr const uint32_t kWriter = 1;
+    static constexpr const uint32_t kWriterWithWaiters = 2;
+
+    struct Slot {
+        Slot()
+            : readers(0) {
+        }
+
+        std::atomic<int64_t> readers;
+        // keeps neighbouring slots off this cache line
+        char padding[kCacheLineSize];
+    };
+
+    // threads are numbered as they first take a read lock, consecutive
+    // numbers spread them over distinct slots
+    static size_t ThreadIndex() {
+        static std::atomic<size_t> next_index(0);
+        static thread_local size_t t_index = next_index.fetch_add(1, std::memory_order_relaxed);
+        return t_index;
+    }
+
+    static size_t RoundUpToPowerOfTwo(size_t n) {
+        size_t power = 1;
+        while (power < n) {
+            power <<= 1;
+        }
+        return power;
+    }
+
+    void WaitForWriter() {
+        uint32_t writer = writer_.load(std::memory_order_relaxed);
+        while (writer != kNoWriter) {
+            if (writer == kWriter &&
+                !writer_.compare_exchange_weak(writer, kWriterWithWaiters, std::memory_order_relaxed)) {
+                continue;
+            }
+            FutexWait(&writer_, kWriterWithWaiters);
+            writer = writer_.load(std::memory_order_relaxed);
+        }
+    }
+
+    const size_t num_slots_;
+    std::unique_ptr<Slot[]> slots_;
+    std::atomic<uint32_t> writer_;
+    // serializes writers
+    Mutex writer_mutex_;
+};
+
+} // namespace arcane
+
+#endif
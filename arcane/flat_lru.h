@@ -0,0 +1,232 @@
+#ifndef ARCANE_FLAT_LRU_H
+#define ARCANE_FLAT_LRU_H
+
+#include <stdint.h>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+namespace arcane {
+
+// Lru with the same interface whose memory is allocated once in the
+// constructor: entries live in a slab of max_size slots linked into the
+// recency list by 32 bit indices, and an open addressing index with linear
+// probing maps keys to slots. The key is stored once, inside the slab, and
+// a hit touches the index and one slab slot instead of a hash node and a
+// list node. Key and T must be default constructible; the cache itself
+// never allocates after construction, copies of Key or T may. A cache of
+// size 0 stores nothing, sizes that do not fit the 32 bit indices throw
+// std::invalid_argument.
+template <typename Key, typename T, typename Hash = std::hash<Key>>
+class FlatLru {
+public:
+    explicit FlatLru(size_t max_size)
+        : max_size_(max_size),
+          size_(0),
+          head_(kNil),
+          tail_(kNil),
+          free_(0),
+          mask_(IndexSize(CheckSize(max_size)) - 1),
+          // one entry even for size 0, which never uses it, keeps the
+          // compiler from seeing an access into an empty array
+          entries_(new Entry[max_size > 0 ? max_size : 1]),
+          index_(new uint32_t[mask_ + 1]),
+          hash_() {
+        for (size_t i = 0; i < max_size; ++i) {
+            entries_[i].next = i + 1 < max_size ? static_cast<uint32_t>(i + 1) : kNil;
+        }
+        for (size_t i = 0; i <= mask_; ++i) {
+            index_[i] = kNil;
+        }
+    }
+
+    FlatLru(const FlatLru&) = delete;
+    FlatLru& operator=(const FlatLru&) = delete;
+
+    void Put(const Key& key, const T& data) {
+        if (max_size_ == 0) {
+            return;
+        }
+        size_t pos = Find(key);
+        if (pos != kNotFound) {
+            uint32_t entry = index_[pos];
+            entries_[entry].data = data;
+            Unlink(entry);
+            LinkTail(entry);
+            return;
+        }
+        if (size_ == max_size_) {
+            Evict(head_);
+        }
+        uint32_t entry = free_;
+        free_ = entries_[entry].next;
+        entries_[entry].key = key;
+        entries_[entry].data = data;
+        LinkTail(entry);
+        pos = Home(key);
+        while (index_[pos] != kNil) {
+            pos = (pos + 1) & mask_;
+        }
+        index_[pos] = entry;
+        ++size_;
+    }
+
+    std::pair<T, bool> Get(const Key& key) {
+        auto res = std::make_pair(T(), false);
+        size_t pos = Find(key);
+        if (pos != kNotFound) {
+            uint32_t entry = index_[pos];
+            res.first = entries_[entry].data;
+            res.second = true;
+            Unlink(entry);
+            LinkTail(entry);
+        }
+        return res;
+    }
+
+    bool Exist(const Key& key) {
+        size_t pos = Find(key);
+        if (pos != kNotFound) {
+            Unlink(index_[pos]);
+            LinkTail(index_[pos]);
+            return true;
+        }
+        return false;
+    }
+
+    void Delete(const Key& key) {
+        size_t pos = Find(key);
+        if (pos != kNotFound) {
+            // releases what the key and value hold now, not on reuse
+            uint32_t entry = index_[pos];
+            Remove(pos);
+            entries_[entry].key = Key();
+            entries_[entry].data = T();
+        }
+    }
+
+    bool Empty() const {
+        return size_ == 0;
+    }
+
+    size_t Size() const {
+        return size_;
+    }
+
+    // bytes allocated by the constructor, fixed for the cache's lifetime
+    size_t MemoryUsage() const {
+        return (max_size_ > 0 ? max_size_ : 1) * sizeof(Entry) + (mask_ + 1) * sizeof(uint32_t);
+    }
+
+private:
+    static constexpr const uint32_t kNil = UINT32_MAX;
+    static constexpr const size_t kNotFound = SIZE_MAX;
+
+    struct Entry {
+        Key key;
+        T data;
+        // neighbours in the recency list, next links the free list too
+        uint32_t prev;
+        uint32_t next;
+    };
+
+    static size_t CheckSize(size_t max_size) {
+        if (max_size >= kNil) {
+            throw std::invalid_argument("FlatLru size does not fit 32 bit indices");
+        }
+        return max_size;
+    }
+
+    // a power of two keeping the index at most half full
+    static size_t IndexSize(size_t max_size) {
+        size_t size = 2;
+        while (size < max_size * 2) {
+            size *= 2;
+        }
+        return size;
+    }
+
+    size_t Home(const Key& key) const {
+        // std::hash of an integer is the integer itself, the multiply
+        // spreads sequential keys, the high bits pick the slot
+        uint64_t hash = static_cast<uint64_t>(hash_(key)) * 0x9e3779b97f4a7c15ULL;
+        return static_cast<size_t>(hash >> 32) & mask_;
+    }
+
+    size_t Find(const Key& key) const {
+        for (size_t pos = Home(key); index_[pos] != kNil; pos = (pos + 1) & mask_) {
+            if (entries_[index_[pos]].key == key) {
+                return pos;
+            }
+        }
+        return kNotFound;
+    }
+
+    void Evict(uint32_t entry) {
+        Remove(Find(entries_[entry].key));
+    }
+
+    // frees the entry at index slot pos and shifts the rest of its probe
+    // run back, so lookups never meet tombstones
+    void Remove(size_t pos) {
+        uint32_t entry = index_[pos];
+        Unlink(entry);
+        entries_[entry].next = free_;
+        free_ = entry;
+        --size_;
+        size_t hole = pos;
+        for (size_t next = (pos + 1) & mask_; index_[next] != kNil; next = (next + 1) & mask_) {
+            size_t home = Home(entries_[index_[next]].key);
+            // an entry may only move back if the hole is not before its home
+            if (((next - home) & mask_) >= ((next - hole) & mask_)) {
+                index_[hole] = index_[next];
+                hole = next;
+            }
+        }
+        index_[hole] = kNil;
+    }
+
+    void Unlink(uint32_t entry) {
+        Entry& e = entries_[entry];
+        if (e.prev != kNil) {
+            entries_[e.prev].next = e.next;
+        } else {
+            head_ = e.next;
+        }
+        if (e.next != kNil) {
+            entries_[e.next].prev = e.prev;
+        } else {
+            tail_ = e.prev;
+        }
+    }
+
+    void LinkTail(uint32_t entry) {
+        Entry& e = entries_[entry];
+        e.prev = tail_;
+        e.next = kNil;
+        if (tail_ != kNil) {
+            entries_[tail_].next = entry;
+        } else {
+            head_ = entry;
+        }
+        tail_ = entry;
+    }
+
+    const size_t max_size_;
+    size_t size_;
+    // least recently used entry
+    uint32_t head_;
+    // most recently used entry
+    uint32_t tail_;
+    // first unused entry
+    uint32_t free_;
+    const size_t mask_;
+    std::unique_ptr<Entry[]> entries_;
+    std::unique_ptr<uint32_t[]> index_;
+    Hash hash_;
+};
+
+} // namespace arcane
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef ARCANE_FUTEX_H
+#define ARCANE_FUTEX_H
+
+#include <stdint.h>
+#include <time.h>
+#include <errno.h>
+#include <unistd.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <atomic>
+
+namespace arcane {
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t),
+              "futex word must be a plain 32 bit integer");
+
+// sleeps while *word == expected, returns false if timeout (relative) expired.
+// spurious wakeups are possible, callers recheck their condition.
+inline bool FutexWait(std::atomic<uint32_t>* word,
+                      uint32_t expected,
+                      const struct timespec* timeout = nullptr) {
+    long ret = syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAIT_PRIVATE,
+                       expected, timeout, nullptr, 0);
+    return !(ret == -1 && errno == ETIMEDOUT);
+}
+
+// wakes up at most num threads sleeping on word
+inline void FutexWake(std::atomic<uint32_t>* word, int num) {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAKE_PRIVATE,
+            num, nullptr, nullptr, 0);
+}
+
+} // namespace arcane
+
+#endif
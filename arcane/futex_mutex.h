@@ -0,0 +1,206 @@
+#ifndef ARCANE_FUTEX_MUTEX_H
+#define ARCANE_FUTEX_MUTEX_H
+
+#include <stdint.h>
+#include <limits.h>
+#include <time.h>
+#include <atomic>
+
+#include <arcane/futex.h>
+#include <arcane/condition.h>
+#include <arcane/thread_utils.h>
+
+namespace arcane {
+
+// records the owning thread for IsLockedByCurrentThread() checks, costs a
+// GetTid() and a store on every lock and unlock.
+class HolderTracking {
+protected:
+    HolderTracking()
+        : holder_(0) {
+    }
+
+    void SetHolder() {
+        holder_ = GetTid();
+    }
+
+    void ResetHolder() {
+        holder_ = 0;
+    }
+
+    bool IsHeldByCurrentThread(bool) const {
+        return holder_ == GetTid();
+    }
+
+private:
+    int64_t holder_;
+};
+
+// no owner is recorded, IsLockedByCurrentThread() only tells if the lock
+// is held by anybody.
+class NoHolderTracking {
+protected:
+    void SetHolder() {
+    }
+
+    void ResetHolder() {
+    }
+
+    bool IsHeldByCurrentThread(bool locked) const {
+        return locked;
+    }
+};
+
+#ifdef NDEBUG
+using DefaultHolderPolicy = NoHolderTracking;
+#else
+using DefaultHolderPolicy = HolderTracking;
+#endif
+
+template <typename HolderPolicy>
+class FutexCondition;
+
+// Mutex on a bare futex word: 0 unlocked, 1 locked, 2 locked with possible
+// waiters. Uncontended Lock and Unlock are one atomic operation each, the
+// kernel is only entered when somebody has to sleep or be woken up.
+template <typename HolderPolicy = DefaultHolderPolicy>
+class FutexMutex : private HolderPolicy {
+public:
+    FutexMutex()
+        : state_(kUnlocked) {
+    }
+
+    FutexMutex(const FutexMutex&) = delete;
+    FutexMutex& operator=(const FutexMutex&) = delete;
+
+    void Lock() {
+        uint32_t state = kUnlocked;
+        if (!state_.compare_exchange_strong(state, kLocked, std::memory_order_acquire)) {
+            LockContended(state);
+        }
+        this->SetHolder();
+    }
+
+    bool TryLock() {
+        uint32_t state = kUnlocked;
+        if (state_.compare_exchange_strong(state, kLocked, std::memory_order_acquire)) {
+            this->SetHolder();
+            return true;
+        }
+        return false;
+    }
+
+    void Unlock() {
+        this->ResetHolder();
+        if (state_.exchange(kUnlocked, std::memory_order_release) == kContended) {
+            FutexWake(&state_, 1);
+        }
+    }
+
+    bool IsLocked() const {
+        return state_.load(std::memory_order_relaxed) != kUnlocked;
+    }
+
+    bool IsLockedByCurrentThread() const {
+        return this->IsHeldByCurrentThread(IsLocked());
+    }
+
+private:
+    friend class FutexCondition<HolderPolicy>;
+
+    static constexpr const uint32_t kUnlocked = 0;
+    static constexpr const uint32_t kLocked = 1;
+    static constexpr const uint32_t kContended = 2;
+
+    void LockContended(uint32_t state) {
+        if (state != kContended) {
+            state = state_.exchange(kContended, std::memory_order_acquire);
+        }
+        while (state != kUnlocked) {
+            FutexWait(&state_, kContended);
+            state = state_.exchange(kContended, std::memory_order_acquire);
+        }
+    }
+
+    // a thread woken from a condition wait may not be the only waiter left
+    void LockAfterWait() {
+        LockContended(kLocked);
+        this->SetHolder();
+    }
+
+    std::atomic<uint32_t> state_;
+};
+
+// Condition variable for FutexMutex: waiters sleep on a sequence number
+// bumped by every notification, which is skipped entirely while nobody
+// waits. Notify with the mutex held to not miss a waiter.
+template <typename HolderPolicy = DefaultHolderPolicy>
+class FutexCondition {
+public:
+    explicit FutexCondition(FutexMutex<HolderPolicy>& mutex)
+        : mutex_(mutex),
+          sequence_(0),
+          waiters_(0) {
+    }
+
+    FutexCondition(const FutexCondition&) = delete;
+    FutexCondition& operator=(const FutexCondition&) = delete;
+
+    void Wait() {
+        WaitFor(nullptr);
+    }
+
+    // returns true if time out, false otherwise.
+    bool TimedWaitMicroseconds(int64_t microseconds) {
+        constexpr const int64_t kMicrosecondsPerSecond = 1e6;
+        struct timespec timeout;
+        timeout.tv_sec = static_cast<time_t>(microseconds / kMicrosecondsPerSecond);
+        timeout.tv_nsec = static_cast<long>(microseconds % kMicrosecondsPerSecond * 1000);
+        return !WaitFor(&timeout);
+    }
+
+    // returns true if time out, false otherwise.
+    bool TimedWaitSeconds(int seconds) {
+        constexpr const int64_t kMicrosecondsPerSecond = 1e6;
+        return TimedWaitMicroseconds(seconds * kMicrosecondsPerSecond);
+    }
+
+    void Notify() {
+        if (waiters_.load(std::memory_order_relaxed) > 0) {
+            sequence_.fetch_add(1, std::memory_order_release);
+            FutexWake(&sequence_, 1);
+        }
+    }
+
+    void NotifyAll() {
+        if (waiters_.load(std::memory_order_relaxed) > 0) {
+            sequence_.fetch_add(1, std::memory_order_release);
+            FutexWake(&sequence_, INT_MAX);
+        }
+    }
+
+private:
+    // returns false if timeout expired
+    bool WaitFor(const struct timespec* timeout) {
+        uint32_t sequence = sequence_.load(std::memory_order_relaxed);
+        waiters_.fetch_add(1, std::memory_order_relaxed);
+        mutex_.Unlock();
+        bool woken = FutexWait(&sequence_, sequence, timeout);
+        waiters_.fetch_sub(1, std::memory_order_relaxed);
+        mutex_.LockAfterWait();
+        return woken;
+    }
+
+    FutexMutex<HolderPolicy>& mutex_;
+    std::atomic<uint32_t> sequence_;
+    std::atomic<uint32_t> waiters_;
+};
+
+template <typename HolderPolicy>
+struct ConditionOf<FutexMutex<HolderPolicy>> {
+    using type = FutexCondition<HolderPolicy>;
+};
+
+} // namespace arcane
+
+#endif
@@ -2,67 +2,372 @@
 #define ARCANE_FUTURE_H
 
 #include <stdint.h>
+#include <limits.h>
+#include <time.h>
+#include <atomic>
+#include <memory>
+#include <vector>
 #include <functional>
 #include <utility>
+#include <coroutine>
+#include <type_traits>
 
 #include <arcane/thread_pool.h>
-#include <arcane/mutex.h>
-#include <arcane/lock_guard.h>
-#include <arcane/condition.h>
+#include <arcane/futex.h>
+#include <arcane/unique_task.h>
+#include <arcane/cancellation.h>
 
 namespace arcane {
 
-template <typename T, typename Queue = std::deque<ThreadPoolTask>>
+namespace detail {
+
+// State shared by a Future and the pool task producing its result. The
+// completion is one atomic word, a waiter marks itself there before going
+// to sleep on the futex, so completing without waiters and reading a ready
+// result cost no syscall. Continuations are kept in a lock-free stack which
+// is closed on completion. The state doubles as the future's own
+// cancellation flag.
+template <typename T>
+class FutureState : public CancellationState {
+public:
+    FutureState()
+        : state_(0),
+          callbacks_(nullptr) {
+    }
+
+    ~FutureState() {
+        CallbackNode* node = callbacks_.load(std::memory_order_acquire);
+        while (node != nullptr && node != Closed()) {
+            CallbackNode* next = node->next;
+            delete node;
+            node = next;
+        }
+    }
+
+    FutureState(const FutureState&) = delete;
+    FutureState& operator=(const FutureState&) = delete;
+
+    void SetValue(T&& value) {
+        result_ = std::move(value);
+        if (state_.exchange(kReady, std::memory_order_acq_rel) & kHasWaiter) {
+            FutexWake(&state_, INT_MAX);
+        }
+        RunCallbacks(callbacks_.exchange(Closed(), std::memory_order_acq_rel));
+    }
+
+    // runs callback in the completing thread, or right away if already done
+    void OnReady(UniqueTask&& callback) {
+        CallbackNode* head = callbacks_.load(std::memory_order_acquire);
+        if (head != Closed()) {
+            CallbackNode* node = new CallbackNode(std::move(callback), head);
+            while (node->next != Closed()) {
+                if (callbacks_.compare_exchange_weak(node->next, node,
+                                                     std::memory_order_release,
+                                                     std::memory_order_acquire)) {
+                    return;
+                }
+            }
+            callback = std::move(node->task);
+            delete node;
+        }
+        callback();
+    }
+
+    T Get() {
+        Wait(nullptr);
+        return result_;
+    }
+
+    std::pair<T, bool> Get(int64_t microseconds) {
+        struct timespec deadline;
+        clock_gettime(CLOCK_MONOTONIC, &deadline);
+        constexpr const int64_t kNanoSecondsPerSecond = 1e9;
+        int64_t nanoseconds = microseconds * 1000 + deadline.tv_nsec;
+        deadline.tv_sec += static_cast<time_t>(nanoseconds / kNanoSecondsPerSecond);
+        deadline.tv_nsec = static_cast<long>(nanoseconds % kNanoSecondsPerSecond);
+        if (!Wait(&deadline)) {
+            return std::make_pair(T(), false);
+        }
+        return std::make_pair(result_, true);
+    }
+
+    bool IsReady() const {
+        return state_.load(std::memory_order_acquire) & kReady;
+    }
+
+    // only valid once done, the result is never written again
+    const T& Value() const {
+        return result_;
+    }
+
+private:
+    static constexpr const uint32_t kReady = 1;
+    static constexpr const uint32_t kHasWaiter = 2;
+
+    struct CallbackNode {
+        CallbackNode(UniqueTask&& callback, CallbackNode* n)
+            : task(std::move(callback)),
+              next(n) {
+        }
+
+        UniqueTask task;
+        CallbackNode* next;
+    };
+
+    // marks the callback stack as closed, never a real node
+    CallbackNode* Closed() {
+        return reinterpret_cast<CallbackNode*>(this);
+    }
+
+    // returns false if deadline (CLOCK_MONOTONIC) passed before completion
+    bool Wait(const struct timespec* deadline) {
+        uint32_t state = state_.load(std::memory_order_acquire);
+        while (!(state & kReady)) {
+            if (!(state & kHasWaiter)) {
+                if (!state_.compare_exchange_weak(state, state | kHasWaiter,
+                                                  std::memory_order_acquire)) {
+                    continue;
+                }
+                state |= kHasWaiter;
+            }
+            if (deadline == nullptr) {
+                FutexWait(&state_, state);
+            } else {
+                struct timespec timeout;
+                if (!RemainingTime(*deadline, &timeout) || !FutexWait(&state_, state, &timeout)) {
+                    return IsReady();
+                }
+            }
+            state = state_.load(std::memory_order_acquire);
+        }
+        return true;
+    }
+
+    static bool RemainingTime(const struct timespec& deadline, struct timespec* remaining) {
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        remaining->tv_sec = deadline.tv_sec - now.tv_sec;
+        remaining->tv_nsec = deadline.tv_nsec - now.tv_nsec;
+        if (remaining->tv_nsec < 0) {
+            --remaining->tv_sec;
+            remaining->tv_nsec += 1000000000;
+        }
+        return remaining->tv_sec >= 0;
+    }
+
+    // callbacks were pushed in front, run them in registration order
+    void RunCallbacks(CallbackNode* head) {
+        CallbackNode* reversed = nullptr;
+        while (head != nullptr) {
+            CallbackNode* next = head->next;
+            head->next = reversed;
+            reversed = head;
+            head = next;
+        }
+        while (reversed != nullptr) {
+            CallbackNode* next = reversed->next;
+            reversed->task();
+            delete reversed;
+            reversed = next;
+        }
+    }
+
+    std::atomic<uint32_t> state_;
+    std::atomic<CallbackNode*> callbacks_;
+    T result_;
+};
+
+} // namespace detail
+
+// Pool is any executor providing Emplace(), ThreadPool<Queue, Lock> or WorkStealingThreadPool
+template <typename T, typename Pool = ThreadPool<>>
 class Future {
 public:
     using Task = std::function<T ()>;
 
-    Future(ThreadPool<Queue>& pool, const Task& task)
-        : done_(false),
-          pool_(pool),
-          mutex_(),
-          cond_(mutex_) {
-        pool_.RunTask(std::bind(&Future::RunInThread, this, task));
+    // F is any callable returning T, it is stored in the pool task as is
+    // instead of being wrapped into a Task. F may take the future's
+    // CancellationToken to notice a cancellation while it runs.
+    template <typename F>
+    Future(Pool& pool, F&& f)
+        : pool_(&pool),
+          state_(std::make_shared<State>()),
+          token_(state_) {
+        Submit(std::forward<F>(f));
+    }
+
+    // shares token with other work, e.g. all futures of one request
+    template <typename F>
+    Future(Pool& pool, F&& f, CancellationToken token)
+        : pool_(&pool),
+          state_(std::make_shared<State>()),
+          token_(std::move(token)) {
+        Submit(std::forward<F>(f));
     }
 
+    Future(Future&&) = default;
+    Future& operator=(Future&&) = default;
+
     Future(const Future&) = delete;
     Future& operator=(const Future&) = delete;
 
     T Get() {
-        LockGuard<Mutex> guard(mutex_);
-        while (!done_) {
-            cond_.Wait();
-        }
-        return result_;
+        return state_->Get();
     }
 
+    // cancels the token if the result is not ready in time, the task is
+    // skipped if it did not start yet
     std::pair<T, bool> Get(int64_t microseconds) {
-        LockGuard<Mutex> guard(mutex_);
-        while (!done_) {
-            if (cond_.TimedWaitMicroseconds(microseconds)) {
-                return std::make_pair(T(), false);
-            }
+        std::pair<T, bool> result = state_->Get(microseconds);
+        if (!result.second) {
+            token_.Cancel();
         }
-        return std::make_pair(result_, true);
+        return result;
+    }
+
+    bool IsReady() const {
+        return state_->IsReady();
+    }
+
+    // a task cancelled before it started is skipped and the future gets
+    // T(), a running one is told through its token
+    void Cancel() {
+        token_.Cancel();
+    }
+
+    bool IsCancelled() const {
+        return token_.IsCancelled();
+    }
+
+    CancellationToken Token() const {
+        return token_;
+    }
+
+    // co_await future suspends the coroutine until the result is ready,
+    // it is resumed in the thread completing the future.
+    bool await_ready() const {
+        return state_->IsReady();
+    }
+
+    void await_suspend(std::coroutine_handle<> handle) {
+        state_->OnReady([handle]() {
+            handle.resume();
+        });
+    }
+
+    T await_resume() const {
+        return state_->Value();
+    }
+
+    // schedules f(result) on the pool once the result is ready without
+    // blocking anybody, the returned future holds what f returns.
+    template <typename F>
+    Future<decltype(std::declval<F&>()(std::declval<const T&>())), Pool> Then(F&& f) {
+        using R = decltype(std::declval<F&>()(std::declval<const T&>()));
+        Future<R, Pool> next(*pool_);
+        Pool* pool = pool_;
+        std::shared_ptr<State> state = state_;
+        std::shared_ptr<detail::FutureState<R>> next_state = next.state_;
+        state_->OnReady([pool, state, next_state, func = std::forward<F>(f)]() mutable {
+            pool->Emplace([state, next_state, func = std::move(func)]() mutable {
+                if (next_state->IsCancelled()) {
+                    next_state->SetValue(R());
+                } else {
+                    next_state->SetValue(func(state->Value()));
+                }
+            });
+        });
+        return next;
     }
 
 private:
-    void RunInThread(Task task) {
-        T ret = task();
-        LockGuard<Mutex> guard(mutex_);
-        result_ = std::move(ret);
-        done_ = true;
-        cond_.Notify();
-    }
-
-    bool done_;
-    ThreadPool<Queue>& pool_;
-    Mutex mutex_;
-    Condition cond_;
-    T result_;
+    template <typename U, typename P>
+    friend class Future;
+
+    template <typename U, typename P>
+    friend Future<std::vector<U>, P> WhenAll(P& pool, const std::vector<Future<U, P>>& futures);
+
+    template <typename U, typename P>
+    friend Future<std::pair<size_t, U>, P> WhenAny(P& pool, const std::vector<Future<U, P>>& futures);
+
+    using State = detail::FutureState<T>;
+
+    // a future completed by continuations instead of a pool task
+    explicit Future(Pool& pool)
+        : pool_(&pool),
+          state_(std::make_shared<State>()),
+          token_(state_) {
+    }
+
+    template <typename F>
+    void Submit(F&& f) {
+        pool_->Emplace([state = state_, token = token_, task = std::forward<F>(f)]() mutable {
+            if (token.IsCancelled()) {
+                state->SetValue(T());
+            } else if constexpr (std::is_invocable<typename std::decay<F>::type&, const CancellationToken&>::value) {
+                state->SetValue(task(static_cast<const CancellationToken&>(token)));
+            } else {
+                state->SetValue(task());
+            }
+        });
+    }
+
+    Pool* pool_;
+    std::shared_ptr<State> state_;
+    CancellationToken token_;
 };
 
+// ready once all futures are, results are in the order of futures.
+template <typename T, typename Pool>
+Future<std::vector<T>, Pool> WhenAll(Pool& pool, const std::vector<Future<T, Pool>>& futures) {
+    struct Aggregate {
+        std::vector<T> values;
+        std::atomic<size_t> remaining;
+    };
+
+    Future<std::vector<T>, Pool> all(pool);
+    if (futures.empty()) {
+        all.state_->SetValue(std::vector<T>());
+        return all;
+    }
+    std::shared_ptr<Aggregate> aggregate = std::make_shared<Aggregate>();
+    aggregate->values.resize(futures.size());
+    aggregate->remaining = futures.size();
+    auto all_state = all.state_;
+    for (size_t i = 0; i < futures.size(); ++i) {
+        auto state = futures[i].state_;
+        state->OnReady([aggregate, all_state, state, i]() {
+            aggregate->values[i] = state->Value();
+            if (aggregate->remaining.fetch_sub(1) == 1) {
+                all_state->SetValue(std::move(aggregate->values));
+            }
+        });
+    }
+    return all;
+}
+
+// ready once the first of futures is, holds its index and result.
+// an empty futures yields (0, T()).
+template <typename T, typename Pool>
+Future<std::pair<size_t, T>, Pool> WhenAny(Pool& pool, const std::vector<Future<T, Pool>>& futures) {
+    Future<std::pair<size_t, T>, Pool> any(pool);
+    if (futures.empty()) {
+        any.state_->SetValue(std::make_pair(static_cast<size_t>(0), T()));
+        return any;
+    }
+    std::shared_ptr<std::atomic<bool>> done = std::make_shared<std::atomic<bool>>(false);
+    auto any_state = any.state_;
+    for (size_t i = 0; i < futures.size(); ++i) {
+        auto state = futures[i].state_;
+        state->OnReady([done, any_state, state, i]() {
+            if (!done->exchange(true)) {
+                any_state->SetValue(std::make_pair(i, state->Value()));
+            }
+        });
+    }
+    return any;
+}
+
 } // namespace arcane
 
 #endif
-
@@ -1,16 +1,30 @@
 #ifndef ARCANE_LOCK_GUARD_H
 #define ARCANE_LOCK_GUARD_H
 
+#include <source_location>
+
 #include <arcane/rwlock.h>
+#include <arcane/lock_profiler.h>
 
 namespace arcane {
 
 template <typename Lock>
 class LockGuard {
 public:
-    LockGuard(Lock& lock)
+    LockGuard(Lock& lock, [[maybe_unused]] const std::source_location& site = std::source_location::current())
         : lock_(lock) {
+#ifdef ARCANE_LOCK_PROFILING
+        bool profiled = IsProfiledLock<Lock>::value && LockProfiler::IsEnabled();
+        if (profiled) {
+            LockProfiler::SetSite(site);
+        }
+        lock_.Lock();
+        if (profiled) {
+            LockProfiler::ClearSite();
+        }
+#else
         lock_.Lock();
+#endif
     }
 
     ~LockGuard() {
@@ -24,40 +38,66 @@ private:
     Lock& lock_;
 };
 
+// Lock is RWLock or DistributedRWLock
+template <typename Lock = RWLock>
 class ReadLockGuard {
 public:
-    ReadLockGuard(RWLock& lock)
+    ReadLockGuard(Lock& lock, [[maybe_unused]] const std::source_location& site = std::source_location::current())
         : lock_(lock) {
+#ifdef ARCANE_LOCK_PROFILING
+        bool profiled = IsProfiledLock<Lock>::value && LockProfiler::IsEnabled();
+        if (profiled) {
+            LockProfiler::SetSite(site);
+        }
         lock_.ReadLock();
+        if (profiled) {
+            LockProfiler::ClearSite();
+        }
+#else
+        lock_.ReadLock();
+#endif
     }
 
     ~ReadLockGuard() {
-        lock_.Unlock();
+        lock_.ReadUnlock();
     }
 
     ReadLockGuard(const ReadLockGuard&) = delete;
     ReadLockGuard& operator=(const ReadLockGuard&) = delete;
 
 private:
-    RWLock& lock_;    
+    Lock& lock_;
 };
 
+// Lock is RWLock or DistributedRWLock
+template <typename Lock = RWLock>
 class WriteLockGuard {
 public:
-    WriteLockGuard(RWLock& lock)
+    WriteLockGuard(Lock& lock, [[maybe_unused]] const std::source_location& site = std::source_location::current())
         : lock_(lock) {
+#ifdef ARCANE_LOCK_PROFILING
+        bool profiled = IsProfiledLock<Lock>::value && LockProfiler::IsEnabled();
+        if (profiled) {
+            LockProfiler::SetSite(site);
+        }
+        lock_.WriteLock();
+        if (profiled) {
+            LockProfiler::ClearSite();
+        }
+#else
         lock_.WriteLock();
+#endif
     }
 
     ~WriteLockGuard() {
-        lock_.Unlock();
+        lock_.WriteUnlock();
     }
 
     WriteLockGuard(const WriteLockGuard&) = delete;
     WriteLockGuard& operator=(const WriteLockGuard&) = delete;
 
 private:
-    RWLock& lock_;
+    Lock& lock_;
 };
 
 } // namespace arcane
@@ -0,0 +1,243 @@
+
+#include <arcane/lock_profiler.h>
+
+#ifdef ARCANE_LOCK_PROFILING
+
+#include <algorithm>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+#include <arcane/futex_mutex.h>
+#include <arcane/log.h>
+
+namespace arcane {
+
+namespace detail {
+
+// wait and hold times in ns go to bucket floor(log2(ns)), the last one
+// takes everything above about a second
+constexpr const int kLockHistogramBuckets = 32;
+constexpr const size_t kLockProfilerShards = 16;
+
+struct LockSiteKey {
+    const void* lock;
+    const char* file;
+    uint32_t line;
+
+    bool operator==(const LockSiteKey& other) const {
+        return lock == other.lock && file == other.file && line == other.line;
+    }
+};
+
+struct LockSiteKeyHash {
+    size_t operator()(const LockSiteKey& key) const {
+        return std::hash<const void*>()(key.lock) * 31 +
+               std::hash<const void*>()(key.file) * 17 + key.line;
+    }
+};
+
+struct LockSiteStats {
+    LockSiteStats()
+        : kind(""),
+          function(""),
+          acquisitions(0),
+          contended(0),
+          total_wait(0),
+          max_wait(0),
+          total_hold(0),
+          max_hold(0),
+          wait_histogram(),
+          hold_histogram() {
+    }
+
+    const char* kind;
+    const char* function;
+    int64_t acquisitions;
+    int64_t contended;
+    int64_t total_wait;
+    int64_t max_wait;
+    int64_t total_hold;
+    int64_t max_hold;
+    int64_t wait_histogram[kLockHistogramBuckets];
+    int64_t hold_histogram[kLockHistogramBuckets];
+};
+
+// the profiler must not use the locks it profiles
+struct LockProfilerShard {
+    FutexMutex<NoHolderTracking> mutex;
+    std::unordered_map<LockSiteKey, LockSiteStats, LockSiteKeyHash> stats;
+};
+
+LockProfilerShard g_lock_profiler_shards[kLockProfilerShards];
+
+// locks a shard without LockGuard, which would pass a call site on
+class ShardGuard {
+public:
+    explicit ShardGuard(LockProfilerShard& shard)
+        : mutex_(shard.mutex) {
+        mutex_.Lock();
+    }
+
+    ~ShardGuard() {
+        mutex_.Unlock();
+    }
+
+    ShardGuard(const ShardGuard&) = delete;
+    ShardGuard& operator=(const ShardGuard&) = delete;
+
+private:
+    FutexMutex<NoHolderTracking>& mutex_;
+};
+
+thread_local std::source_location t_lock_site;
+thread_local bool t_has_lock_site = false;
+
+int HistogramBucket(int64_t nanoseconds) {
+    if (nanoseconds <= 1) {
+        return 0;
+    }
+    int bucket = 63 - __builtin_clzll(static_cast<uint64_t>(nanoseconds));
+    return std::min(bucket, kLockHistogramBuckets - 1);
+}
+
+// upper bound of the bucket holding the given fraction of samples
+int64_t Percentile(const int64_t* histogram, int64_t total, int64_t max, double fraction) {
+    int64_t needed = static_cast<int64_t>(total * fraction);
+    int64_t seen = 0;
+    for (int i = 0; i < kLockHistogramBuckets; ++i) {
+        seen += histogram[i];
+        if (seen > needed) {
+            return std::min(static_cast<int64_t>(2) << i, max);
+        }
+    }
+    return max;
+}
+
+} // namespace detail
+
+std::atomic<bool> LockProfiler::enabled_(false);
+
+LockProfiler::LockProfiler() {
+}
+
+LockProfiler& LockProfiler::GetInstance() {
+    static LockProfiler profiler;
+    return profiler;
+}
+
+void LockProfiler::Enable() {
+    enabled_.store(true, std::memory_order_relaxed);
+}
+
+void LockProfiler::Disable() {
+    enabled_.store(false, std::memory_order_relaxed);
+}
+
+void LockProfiler::Reset() {
+    for (auto& shard : detail::g_lock_profiler_shards) {
+        detail::ShardGuard guard(shard);
+        shard.stats.clear();
+    }
+}
+
+void LockProfiler::SetSite(const std::source_location& site) {
+    detail::t_lock_site = site;
+    detail::t_has_lock_site = true;
+}
+
+void LockProfiler::ClearSite() {
+    detail::t_has_lock_site = false;
+}
+
+std::source_location LockProfiler::TakeSite() {
+    if (!detail::t_has_lock_site) {
+        return std::source_location();
+    }
+    detail::t_has_lock_site = false;
+    return detail::t_lock_site;
+}
+
+void LockProfiler::Record(const char* kind, const detail::LockProfileSlot& done) {
+    detail::LockSiteKey key = {done.lock, done.site.file_name(), done.site.line()};
+    // locks are at least 8 byte aligned and often a cache line apart
+    size_t index = (reinterpret_cast<uintptr_t>(done.lock) >> 6) % detail::kLockProfilerShards;
+    detail::LockProfilerShard& shard = detail::g_lock_profiler_shards[index];
+    detail::ShardGuard guard(shard);
+    detail::LockSiteStats& stats = shard.stats[key];
+    stats.kind = kind;
+    stats.function = done.site.function_name();
+    ++stats.acquisitions;
+    if (done.contended) {
+        ++stats.contended;
+    }
+    stats.total_wait += done.wait;
+    stats.max_wait = std::max(stats.max_wait, done.wait);
+    stats.total_hold += done.hold;
+    stats.max_hold = std::max(stats.max_hold, done.hold);
+    ++stats.wait_histogram[detail::HistogramBucket(done.wait)];
+    ++stats.hold_histogram[detail::HistogramBucket(done.hold)];
+}
+
+void LockProfiler::Dump(size_t top_n) {
+    struct Site {
+        detail::LockSiteKey key;
+        detail::LockSiteStats stats;
+    };
+
+    struct Lock {
+        const void* lock = nullptr;
+        int64_t total_wait = 0;
+        int64_t contended = 0;
+        std::vector<Site> sites;
+    };
+
+    // copied out first, logging may take profiled locks
+    std::unordered_map<const void*, Lock> locks;
+    for (auto& shard : detail::g_lock_profiler_shards) {
+        detail::ShardGuard guard(shard);
+        for (auto& entry : shard.stats) {
+            Lock& lock = locks[entry.first.lock];
+            lock.lock = entry.first.lock;
+            lock.total_wait += entry.second.total_wait;
+            lock.contended += entry.second.contended;
+            lock.sites.push_back(Site{entry.first, entry.second});
+        }
+    }
+    std::vector<Lock> sorted;
+    sorted.reserve(locks.size());
+    for (auto& entry : locks) {
+        sorted.push_back(std::move(entry.second));
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const Lock& a, const Lock& b) {
+        return a.total_wait > b.total_wait;
+    });
+    if (sorted.size() > top_n) {
+        sorted.resize(top_n);
+    }
+
+    LOG_INFO << "lock profile, top " << sorted.size() << " of " << locks.size() << " locks by wait time";
+    for (auto& lock : sorted) {
+        std::sort(lock.sites.begin(), lock.sites.end(), [](const Site& a, const Site& b) {
+            return a.stats.total_wait > b.stats.total_wait;
+        });
+        LOG_INFO << "lock " << lock.lock << " contended:" << lock.contended << " total wait ns:" << lock.total_wait;
+        for (auto& site : lock.sites) {
+            const detail::LockSiteStats& stats = site.stats;
+            LOG_INFO << "    " << stats.kind << " at " << (site.key.line != 0 ? site.key.file : "unknown site")
+                     << ":" << site.key.line << " " << stats.function
+                     << " acquisitions:" << stats.acquisitions
+                     << " contended:" << stats.contended
+                     << " wait ns p50:" << detail::Percentile(stats.wait_histogram, stats.acquisitions, stats.max_wait, 0.5)
+                     << " p99:" << detail::Percentile(stats.wait_histogram, stats.acquisitions, stats.max_wait, 0.99)
+                     << " max:" << stats.max_wait
+                     << " hold ns p50:" << detail::Percentile(stats.hold_histogram, stats.acquisitions, stats.max_hold, 0.5)
+                     << " p99:" << detail::Percentile(stats.hold_histogram, stats.acquisitions, stats.max_hold, 0.99)
+                     << " max:" << stats.max_hold;
+        }
+    }
+}
+
+} // namespace arcane
+
+#endif // ARCANE_LOCK_PROFILING
@@ -0,0 +1,126 @@
+#ifndef ARCANE_LOCK_PROFILER_H
+#define ARCANE_LOCK_PROFILER_H
+
+#include <stdint.h>
+#include <time.h>
+#include <atomic>
+#include <source_location>
+#include <type_traits>
+
+// The profiler is compiled in with ARCANE_LOCK_PROFILING defined for the
+// whole build (cmake -DARCANE_LOCK_PROFILING=ON), without it the locks keep
+// their plain layout and code and this header declares nothing.
+#ifdef ARCANE_LOCK_PROFILING
+
+namespace arcane {
+
+namespace detail {
+
+// one acquisition in flight, kept by the lock (or the thread for read
+// locks) until it is released
+struct LockProfileSlot {
+    LockProfileSlot()
+        : lock(nullptr),
+          acquired_at(0),
+          wait(0),
+          hold(0),
+          contended(false) {
+    }
+
+    const void* lock;
+    std::source_location site;
+    // 0 while no profiled acquisition is held
+    int64_t acquired_at;
+    int64_t wait;
+    int64_t hold;
+    bool contended;
+};
+
+} // namespace detail
+
+// true for the locks reporting to the profiler, only their guards pass a
+// call site, a site set for any other lock would be taken by the next
+// profiled lock of the thread
+template <typename Lock>
+struct IsProfiledLock : std::false_type {
+};
+
+// Records for every lock and LockGuard call site how often it was taken,
+// how often it had to wait, and histograms of wait and hold times. Mutex,
+// SpinLock and RWLock report to it while it is enabled; disabled, a lock of
+// a profiling build pays a load of the enabled flag and a branch. Sites are passed in by
+// LockGuard, ReadLockGuard and WriteLockGuard, a lock taken directly is
+// recorded under an unknown site.
+class LockProfiler {
+public:
+    static LockProfiler& GetInstance();
+
+    static bool IsEnabled() {
+        return enabled_.load(std::memory_order_relaxed);
+    }
+
+    void Enable();
+    void Disable();
+    void Reset();
+
+    // logs the top_n locks by total wait time with their call sites
+    void Dump(size_t top_n = 10);
+
+    // called by the guards right before locking
+    static void SetSite(const std::source_location& site);
+
+    // returns the site set for this thread and forgets it
+    static std::source_location TakeSite();
+
+    // forgets a site the lock did not take, profiling may have been
+    // disabled between SetSite and locking
+    static void ClearSite();
+
+    static int64_t Now() {
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return static_cast<int64_t>(now.tv_sec) * 1000000000 + now.tv_nsec;
+    }
+
+    // try_lock returns false if the lock is busy, lock blocks until taken
+    template <typename TryLockFunc, typename LockFunc>
+    static void ProfiledLock(const void* lock, detail::LockProfileSlot& slot,
+                             TryLockFunc&& try_lock, LockFunc&& lock_func) {
+        std::source_location site = TakeSite();
+        int64_t begin = Now();
+        bool contended = !try_lock();
+        if (contended) {
+            lock_func();
+        }
+        slot.lock = lock;
+        slot.site = site;
+        slot.contended = contended;
+        slot.acquired_at = Now();
+        slot.wait = slot.acquired_at - begin;
+    }
+
+    // takes the finished acquisition out of slot, to be passed to Record
+    // once the lock is released
+    static detail::LockProfileSlot Finish(detail::LockProfileSlot& slot) {
+        detail::LockProfileSlot done = slot;
+        done.hold = Now() - done.acquired_at;
+        slot.acquired_at = 0;
+        return done;
+    }
+
+    void Record(const char* kind, const detail::LockProfileSlot& done);
+
+private:
+    LockProfiler();
+
+    LockProfiler(const LockProfiler&) = delete;
+    LockProfiler& operator=(const LockProfiler&) = delete;
+
+    static std::atomic<bool> enabled_;
+};
+
+} // namespace arcane
+
+#endif // ARCANE_LOCK_PROFILING
+
+#endif
@@ -1,111 +1,223 @@
 #ifndef ARCANE_LRU_H
 #define ARCANE_LRU_H
 
+#include <array>
+#include <functional>
 #include <list>
 #include <unordered_map>
 #include <utility>
 
 namespace arcane {
 
-// List iterator must stable, 
-// other iterator of list must valid after list insert or erase
+namespace detail {
+
+// Entries of an eviction policy kept in N recency ordered lists, least
+// recent at the front, with one index over all of them. List iterators
+// stay valid when entries move between lists, the index holds them.
+template <typename Key, typename T, typename Hash, size_t N>
+class LruSegments {
+public:
+    using List = std::list<std::pair<Key, T>>;
+
+    struct Node {
+        typename List::iterator it;
+        size_t segment;
+    };
+
+    LruSegments() {
+    }
+
+    LruSegments(const LruSegments& other)
+        : lists_(other.lists_) {
+        Reindex();
+    }
+
+    LruSegments(LruSegments&& other) = default;
+
+    LruSegments& operator=(const LruSegments& other) {
+        lists_ = other.lists_;
+        Reindex();
+        return *this;
+    }
+
+    LruSegments& operator=(LruSegments&& other) = default;
+
+    // stays valid until the entry is erased
+    Node* Find(const Key& key) {
+        auto it = map_.find(key);
+        return it != map_.end() ? &it->second : nullptr;
+    }
+
+    // key must not be present
+    void PushBack(size_t segment, const Key& key, const T& data) {
+        auto it = lists_[segment].insert(lists_[segment].end(), std::make_pair(key, data));
+        map_.emplace(key, Node{it, segment});
+    }
+
+    // to the back of segment, which may be the one node is in
+    void MoveToBack(Node* node, size_t segment) {
+        lists_[segment].splice(lists_[segment].end(), lists_[node->segment], node->it);
+        node->segment = segment;
+    }
+
+    Node* Front(size_t segment) {
+        return Find(lists_[segment].front().first);
+    }
+
+    void PopFront(size_t segment) {
+        map_.erase(lists_[segment].front().first);
+        lists_[segment].pop_front();
+    }
+
+    void Erase(Node* node) {
+        typename List::iterator it = node->it;
+        List& list = lists_[node->segment];
+        map_.erase(it->first);
+        list.erase(it);
+    }
+
+    size_t Size(size_t segment) const {
+        return lists_[segment].size();
+    }
+
+private:
+    void Reindex() {
+        map_.clear();
+        for (size_t segment = 0; segment < N; ++segment) {
+            for (auto it = lists_[segment].begin(); it != lists_[segment].end(); ++it) {
+                map_.emplace(it->first, Node{it, segment});
+            }
+        }
+    }
+
+    std::array<List, N> lists_;
+    std::unordered_map<Key, Node, Hash> map_;
+};
+
+} // namespace detail
+
+// An eviction policy for Lru provides
+//     template <typename Key, typename T, typename Hash> class Cache
+// with a constructor taking the maximum size and
+//     void Put(const Key& key, const T& data);
+//     T* Find(const Key& key);      // nullptr on a miss, counts as an access
+//     void Erase(const Key& key);
+//     size_t Size() const;
+// and value semantics.
+
+// evicts the least recently used entry
+struct LruPolicy {
+    template <typename Key, typename T, typename Hash>
+    class Cache {
+    public:
+        explicit Cache(size_t max_size)
+            : max_size_(max_size) {
+        }
+
+        void Put(const Key& key, const T& data) {
+            auto node = segments_.Find(key);
+            if (node != nullptr) {
+                node->it->second = data;
+                segments_.MoveToBack(node, 0);
+                return;
+            }
+            segments_.PushBack(0, key, data);
+            if (segments_.Size(0) > max_size_) {
+                segments_.PopFront(0);
+            }
+        }
+
+        T* Find(const Key& key) {
+            auto node = segments_.Find(key);
+            if (node == nullptr) {
+                return nullptr;
+            }
+            segments_.MoveToBack(node, 0);
+            return &node->it->second;
+        }
+
+        void Erase(const Key& key) {
+            auto node = segments_.Find(key);
+            if (node != nullptr) {
+                segments_.Erase(node);
+            }
+        }
+
+        size_t Size() const {
+            return segments_.Size(0);
+        }
+
+    private:
+        size_t max_size_;
+        detail::LruSegments<Key, T, Hash, 1> segments_;
+    };
+};
+
+// A cache of at most max_size entries, not thread safe. Which entry a Put
+// evicts is up to Policy, LruPolicy by default.
 template <
     typename Key, 
     typename T, 
-    typename List = std::list<std::pair<Key, T>>,
-    typename Map = std::unordered_map<Key, typename List::iterator>> 
+    typename Policy = LruPolicy,
+    typename Hash = std::hash<Key>>
 class Lru {
 public:
     explicit Lru(size_t max_size)
-        : max_size_(max_size) {
+        : cache_(max_size) {
     }
 
     Lru(const Lru& lru) 
-        : list_(lru.list_),
-          map_(lru.map_),
-          max_size_(lru.max_size_) {
+        : cache_(lru.cache_) {
     }
 
     Lru(Lru&& lru) 
-        : list_(std::move(lru.list_)),
-          map_(std::move(lru.map_)),
-          max_size_(lru.max_size_) {
+        : cache_(std::move(lru.cache_)) {
     }
 
     Lru& operator=(const Lru& lru) {
-        list_ = lru.list_;
-        map_ = lru.map_;
-        max_size_ = lru.max_size_;
+        cache_ = lru.cache_;
         return *this;
     }
 
     Lru& operator=(Lru&& lru) {
-        list_ = std::move(lru.list_);
-        map_ = std::move(lru.map_);
-        max_size_ = lru.max_size_;
+        cache_ = std::move(lru.cache_);
         return *this;
     }
 
     void Put(const Key& key, const T& data) {
-        auto it = list_.insert(list_.end(), std::make_pair(key, data));
-        auto r = map_.insert(std::make_pair(key, it));
-        if (r.second) {
-            Purge();            
-        } else {
-            list_.erase(r.first->second);
-            r.first->second = it;
-        }
+        cache_.Put(key, data);
     }
 
     std::pair<T, bool> Get(const Key& key) {
         auto res = std::make_pair(T(), false);
-        auto it = map_.find(key);
-        if (it != map_.end()) {
-            res.first = it->second->second;
+        T* data = cache_.Find(key);
+        if (data != nullptr) {
+            res.first = *data;
             res.second = true;
-            list_.splice(list_.end(), list_, it->second);
         }
         return res;
     }
 
     bool Exist(const Key& key) {
-        auto it = map_.find(key);
-        if (it != map_.end()) {
-            list_.splice(list_.end(), list_, it->second); 
-        }
-        return false;
+        return cache_.Find(key) != nullptr;
     }
 
     void Delete(const Key& key) {
-        auto it = map_.find(key);
-        if (it != map_.end()) {
-            list_.erase(it->second);
-            map_.erase(it);
-        }
+        cache_.Erase(key);
     }
 
     bool Empty() const {
-        return list_.empty();
+        return cache_.Size() == 0;
     }
     
     size_t Size() const {
-        return list_.size();
+        return cache_.Size();
     }
 
 private:
-    void Purge() {
-        if (list_.size() >= max_size_) {
-            map_.erase(list_.front().first);
-            list_.pop_front();
-        }
-    }
-
-    List list_;
-    Map map_;
-    size_t max_size_;
+    typename Policy::template Cache<Key, T, Hash> cache_;
 };
 
 } // namespace arcane
 
 #endif
-
@@ -0,0 +1,265 @@
+#ifndef ARCANE_LRU_POLICIES_H
+#define ARCANE_LRU_POLICIES_H
+
+#include <algorithm>
+
+#include <arcane/lru.h>
+
+namespace arcane {
+
+// Segmented LRU: new entries go to a probation segment, entries hit there
+// move to a protected segment of up to 80% of the size, whose least recent
+// entries fall back to probation. Evicts from probation first, so entries
+// used once never push out ones used twice.
+struct SlruPolicy {
+    template <typename Key, typename T, typename Hash>
+    class Cache {
+    public:
+        explicit Cache(size_t max_size)
+            : max_size_(max_size),
+              protected_size_(max_size * 8 / 10) {
+        }
+
+        void Put(const Key& key, const T& data) {
+            auto node = segments_.Find(key);
+            if (node != nullptr) {
+                node->it->second = data;
+                Access(node);
+                return;
+            }
+            segments_.PushBack(kProbation, key, data);
+            if (Size() > max_size_) {
+                segments_.PopFront(segments_.Size(kProbation) > 0 ? kProbation : kProtected);
+            }
+        }
+
+        T* Find(const Key& key) {
+            auto node = segments_.Find(key);
+            if (node == nullptr) {
+                return nullptr;
+            }
+            Access(node);
+            return &node->it->second;
+        }
+
+        void Erase(const Key& key) {
+            auto node = segments_.Find(key);
+            if (node != nullptr) {
+                segments_.Erase(node);
+            }
+        }
+
+        size_t Size() const {
+            return segments_.Size(kProbation) + segments_.Size(kProtected);
+        }
+
+    private:
+        enum Segment {
+            kProbation = 0,
+            kProtected = 1,
+        };
+
+        using Segments = detail::LruSegments<Key, T, Hash, 2>;
+
+        void Access(typename Segments::Node* node) {
+            segments_.MoveToBack(node, kProtected);
+            if (segments_.Size(kProtected) > protected_size_) {
+                segments_.MoveToBack(segments_.Front(kProtected), kProbation);
+            }
+        }
+
+        size_t max_size_;
+        size_t protected_size_;
+        Segments segments_;
+    };
+};
+
+// 2Q: new entries go to a FIFO of 25% of the size, hits there leave them
+// in place. Keys falling out of the FIFO are remembered without their
+// values in a ghost list of up to 50% of the size; a key put again while
+// remembered goes to the main LRU. A scan only churns the FIFO.
+struct TwoQueuePolicy {
+    template <typename Key, typename T, typename Hash>
+    class Cache {
+    public:
+        explicit Cache(size_t max_size)
+            : max_size_(max_size),
+              in_size_(std::max<size_t>(1, max_size / 4)),
+              out_size_(std::max<size_t>(1, max_size / 2)) {
+        }
+
+        void Put(const Key& key, const T& data) {
+            auto node = segments_.Find(key);
+            if (node == nullptr) {
+                segments_.PushBack(kIn, key, data);
+            } else if (node->segment == kOut) {
+                node->it->second = data;
+                segments_.MoveToBack(node, kMain);
+            } else {
+                node->it->second = data;
+                if (node->segment == kMain) {
+                    segments_.MoveToBack(node, kMain);
+                }
+            }
+            while (Size() > max_size_) {
+                Reclaim();
+            }
+        }
+
+        T* Find(const Key& key) {
+            auto node = segments_.Find(key);
+            if (node == nullptr || node->segment == kOut) {
+                return nullptr;
+            }
+            if (node->segment == kMain) {
+                segments_.MoveToBack(node, kMain);
+            }
+            return &node->it->second;
+        }
+
+        void Erase(const Key& key) {
+            auto node = segments_.Find(key);
+            if (node != nullptr) {
+                segments_.Erase(node);
+            }
+        }
+
+        size_t Size() const {
+            return segments_.Size(kIn) + segments_.Size(kMain);
+        }
+
+    private:
+        enum Segment {
+            kIn = 0,
+            kMain = 1,
+            // ghost keys, values are dropped
+            kOut = 2,
+        };
+
+        void Reclaim() {
+            if (segments_.Size(kIn) <= in_size_ && segments_.Size(kMain) > 0) {
+                segments_.PopFront(kMain);
+                return;
+            }
+            auto node = segments_.Front(kIn);
+            node->it->second = T();
+            segments_.MoveToBack(node, kOut);
+            if (segments_.Size(kOut) > out_size_) {
+                segments_.PopFront(kOut);
+            }
+        }
+
+        size_t max_size_;
+        size_t in_size_;
+        size_t out_size_;
+        detail::LruSegments<Key, T, Hash, 3> segments_;
+    };
+};
+
+// Adaptive Replacement Cache: entries seen once and entries seen again are
+// kept in two LRU lists, with ghost lists remembering the keys recently
+// evicted from each. A miss on a ghost key shows which list evicted too
+// early and moves the target split between the two lists towards it, so
+// the cache adapts between recency and frequency without tuning.
+struct ArcPolicy {
+    template <typename Key, typename T, typename Hash>
+    class Cache {
+    public:
+        explicit Cache(size_t max_size)
+            : max_size_(max_size),
+              target_(0) {
+        }
+
+        void Put(const Key& key, const T& data) {
+            auto node = segments_.Find(key);
+            if (node == nullptr) {
+                PutNew(key, data);
+                return;
+            }
+            node->it->second = data;
+            if (node->segment == kRecentGhost) {
+                size_t delta = std::max<size_t>(1, segments_.Size(kFrequentGhost) / segments_.Size(kRecentGhost));
+                target_ = std::min(max_size_, target_ + delta);
+                Replace(false);
+            } else if (node->segment == kFrequentGhost) {
+                size_t delta = std::max<size_t>(1, segments_.Size(kRecentGhost) / segments_.Size(kFrequentGhost));
+                target_ = target_ > delta ? target_ - delta : 0;
+                Replace(true);
+            }
+            segments_.MoveToBack(node, kFrequent);
+        }
+
+        T* Find(const Key& key) {
+            auto node = segments_.Find(key);
+            if (node == nullptr || node->segment == kRecentGhost || node->segment == kFrequentGhost) {
+                return nullptr;
+            }
+            segments_.MoveToBack(node, kFrequent);
+            return &node->it->second;
+        }
+
+        void Erase(const Key& key) {
+            auto node = segments_.Find(key);
+            if (node != nullptr) {
+                segments_.Erase(node);
+            }
+        }
+
+        size_t Size() const {
+            return segments_.Size(kRecent) + segments_.Size(kFrequent);
+        }
+
+    private:
+        enum Segment {
+            kRecent = 0,
+            kFrequent = 1,
+            kRecentGhost = 2,
+            kFrequentGhost = 3,
+        };
+
+        void PutNew(const Key& key, const T& data) {
+            if (max_size_ == 0) {
+                return;
+            }
+            size_t recent = segments_.Size(kRecent) + segments_.Size(kRecentGhost);
+            size_t total = recent + segments_.Size(kFrequent) + segments_.Size(kFrequentGhost);
+            if (recent >= max_size_) {
+                if (segments_.Size(kRecent) < max_size_) {
+                    segments_.PopFront(kRecentGhost);
+                    Replace(false);
+                } else {
+                    segments_.PopFront(kRecent);
+                }
+            } else if (total >= max_size_) {
+                if (total >= 2 * max_size_) {
+                    segments_.PopFront(kFrequentGhost);
+                }
+                Replace(false);
+            }
+            segments_.PushBack(kRecent, key, data);
+        }
+
+        // makes room for one entry by moving the least recent entry of the
+        // list over its target to that list's ghosts
+        void Replace(bool frequent_ghost_hit) {
+            if (Size() < max_size_ || Size() == 0) {
+                return;
+            }
+            size_t recent = segments_.Size(kRecent);
+            bool from_recent = recent > 0 &&
+                (recent > target_ || (frequent_ghost_hit && recent == target_) || segments_.Size(kFrequent) == 0);
+            auto node = segments_.Front(from_recent ? kRecent : kFrequent);
+            node->it->second = T();
+            segments_.MoveToBack(node, from_recent ? kRecentGhost : kFrequentGhost);
+        }
+
+        size_t max_size_;
+        // how many of the entries the recent list should hold
+        size_t target_;
+        detail::LruSegments<Key, T, Hash, 4> segments_;
+    };
+};
+
+} // namespace arcane
+
+#endif
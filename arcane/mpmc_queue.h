@@ -0,0 +1,151 @@
+#ifndef ARCANE_MPMC_QUEUE_H
+#define ARCANE_MPMC_QUEUE_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <atomic>
+#include <new>
+#include <utility>
+#include <type_traits>
+
+namespace arcane {
+
+// ThreadPool guards its queue with a mutex unless the queue synchronizes
+// itself, such queues specialize this trait and provide Reserve, TryPush,
+// TryPop, Size, Empty and Full.
+template <typename Queue>
+struct IsLockFreeQueue : std::false_type {};
+
+// Bounded multi-producer multi-consumer ring buffer, every cell carries a
+// sequence number telling producers and consumers whose turn it is, see:
+// http://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+// Producers only contend on the enqueue position and consumers on the
+// dequeue position, which live on separate cache lines.
+template <typename T>
+class BoundedMpmcQueue {
+public:
+    static constexpr const size_t kDefaultCapacity = 65536;
+
+    BoundedMpmcQueue()
+        : cells_(nullptr),
+          mask_(0),
+          enqueue_pos_(0),
+          dequeue_pos_(0) {
+    }
+
+    ~BoundedMpmcQueue() {
+        if (cells_ != nullptr) {
+            T value;
+            while (TryPop(value)) {
+            }
+            delete[] cells_;
+        }
+    }
+
+    BoundedMpmcQueue(const BoundedMpmcQueue&) = delete;
+    BoundedMpmcQueue& operator=(const BoundedMpmcQueue&) = delete;
+
+    // must be called once before use, capacity is rounded up to a power of 2
+    void Reserve(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        cells_ = new Cell[size];
+        for (size_t i = 0; i < size; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        mask_ = size - 1;
+    }
+
+    // returns false if the queue is full, value is left untouched then.
+    bool TryPush(T&& value) {
+        Cell* cell = nullptr;
+        size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        while (true) {
+            cell = &cells_[pos & mask_];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+        new (&cell->storage) T(std::move(value));
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // returns false if the queue is empty.
+    bool TryPop(T& value) {
+        Cell* cell = nullptr;
+        size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        while (true) {
+            cell = &cells_[pos & mask_];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeue_pos_.compare_exchange_weak(pos, pos + 1)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = dequeue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+        T* p = reinterpret_cast<T*>(&cell->storage);
+        value = std::move(*p);
+        p->~T();
+        cell->sequence.store(pos + mask_ + 1, std::memory_order_release);
+        return true;
+    }
+
+    // approximate while producers or consumers are running
+    size_t Size() const {
+        size_t dequeue_pos = dequeue_pos_.load();
+        size_t enqueue_pos = enqueue_pos_.load();
+        return enqueue_pos > dequeue_pos ? enqueue_pos - dequeue_pos : 0;
+    }
+
+    bool Empty() const {
+        return Size() == 0;
+    }
+
+    bool Full() const {
+        return Size() >= Capacity();
+    }
+
+    size_t Capacity() const {
+        return mask_ + 1;
+    }
+
+private:
+    static constexpr const size_t kCacheLineSize = 64;
+
+    struct Cell {
+        std::atomic<size_t> sequence;
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+    };
+
+    char padding0_[kCacheLineSize];
+    Cell* cells_;
+    size_t mask_;
+    char padding1_[kCacheLineSize - sizeof(Cell*) - sizeof(size_t)];
+    std::atomic<size_t> enqueue_pos_;
+    char padding2_[kCacheLineSize - sizeof(std::atomic<size_t>)];
+    std::atomic<size_t> dequeue_pos_;
+    char padding3_[kCacheLineSize - sizeof(std::atomic<size_t>)];
+};
+
+template <typename T>
+struct IsLockFreeQueue<BoundedMpmcQueue<T>> : std::true_type {};
+
+} // namespace arcane
+
+#endif
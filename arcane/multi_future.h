@@ -3,76 +3,221 @@
 
 #include <stdlib.h>
 #include <vector>
+#include <deque>
+#include <chrono>
+#include <iterator>
 #include <atomic>
 #include <functional>
+#include <memory>
 #include <utility>
 
 #include <arcane/thread_pool.h>
 #include <arcane/mutex.h>
 #include <arcane/lock_guard.h>
 #include <arcane/condition.h>
+#include <arcane/cancellation.h>
 
 namespace arcane {
 
-template <typename T, typename Queue = std::deque<ThreadPoolTask>>
+// Pool is any executor providing RunTasks(), ThreadPool<Queue, Lock> or
+// WorkStealingThreadPool, Lock guards the result, Mutex or FutexMutex<>.
+// The tasks share their state with the MultiFuture, which may go away
+// before they ran. Tasks not started once the token is cancelled are
+// skipped and leave T() in their result.
+//
+// Results can be consumed in completion order with Next instead, to work
+// on early results while slow tasks still run:
+//     std::pair<size_t, T> next;
+//     while (multi_future.Next(&next, remaining_microseconds)) {
+//         Merge(next.first, std::move(next.second));
+//     }
+// Next moves each result out, use either it or Get/Take on a MultiFuture.
+// Once Take moved the results out Next returns false and Remaining 0.
+template <typename T, typename Pool = ThreadPool<>, typename Lock = Mutex>
 class MultiFuture {
 public:
     using Task = std::function<T ()>;
 
-    MultiFuture(ThreadPool<Queue>& pool, const std::vector<Task>& tasks)
-        : done_(false),
-          pool_(pool),
-          mutex_(),
-          cond_(mutex_),
-          finish_num_(0),
-          result_(tasks.size()) {
+    MultiFuture(Pool& pool, const std::vector<Task>& tasks,
+                CancellationToken token = CancellationToken())
+        : state_(std::make_shared<State>(tasks.size(), std::move(token))) {
+        std::vector<ThreadPoolTask> pool_tasks;
+        pool_tasks.reserve(tasks.size());
         for (size_t i = 0; i < tasks.size(); ++i) {
-            pool_.RunTask(std::bind(&MultiFuture::RunInThread, this, tasks[i], i));
+            const Task& task = tasks[i];
+            std::shared_ptr<State> state = state_;
+            pool_tasks.emplace_back([state, task, i]() {
+                state->RunInThread(task, i);
+            });
         }
+        pool.RunTasks(std::make_move_iterator(pool_tasks.begin()),
+                      std::make_move_iterator(pool_tasks.end()));
     }
 
     MultiFuture(const MultiFuture&) = delete;
     MultiFuture& operator=(const MultiFuture&) = delete;
     
     std::vector<T> Get() {
-        LockGuard<Mutex> guard(mutex_);
-        while (!done_) {
-            cond_.Wait();
+        LockGuard<Lock> guard(state_->mutex);
+        while (!state_->done) {
+            state_->cond.Wait();
         }
-        return result_;
+        return state_->result;
     }
 
+    // cancels the token if the results are not all ready in time, tasks
+    // that did not start yet are skipped
     std::pair<std::vector<T>, bool> Get(int64_t microseconds) {
-        LockGuard<Mutex> guard(mutex_);
-        while (!done_) {
-            if (cond_.TimedWaitMicroseconds(microseconds)) {
+        Clock::time_point deadline = Clock::now() + std::chrono::microseconds(microseconds);
+        LockGuard<Lock> guard(state_->mutex);
+        while (!state_->done) {
+            if (!state_->WaitUntil(deadline) && !state_->done) {
+                state_->token.Cancel();
                 std::vector<T> tmp;
                 return std::make_pair(tmp, false);
             }
         }
-        return std::make_pair(result_, true);
+        return std::make_pair(state_->result, true);
     }
 
-private:
-    void RunInThread(Task task, size_t index) {
-        if (result_.empty()) {
-            return;
+    // like Get without copying, the results are moved out, call it once
+    std::vector<T> Take() {
+        LockGuard<Lock> guard(state_->mutex);
+        while (!state_->done) {
+            state_->cond.Wait();
         }
-        result_[index] = task();
-        ++finish_num_; 
-        if (finish_num_.load() >= result_.size()) {
-            LockGuard<Mutex> guard(mutex_);
-            done_ = true;
-            cond_.Notify();
+        state_->taken = true;
+        return std::move(state_->result);
+    }
+
+    // moves the next finished result out with its task index, in the order
+    // tasks finished. returns false once every result was handed out,
+    // skipped tasks have none.
+    bool Next(std::pair<size_t, T>* next) {
+        LockGuard<Lock> guard(state_->mutex);
+        ++state_->waiting_streamers;
+        while (state_->completed.empty() && !state_->Exhausted()) {
+            state_->cond.Wait();
         }
+        --state_->waiting_streamers;
+        return state_->PopCompleted(next);
     }
 
-    bool done_;
-    ThreadPool<Queue>& pool_;
-    Mutex mutex_;
-    Condition cond_;
-    std::atomic<size_t> finish_num_;
-    std::vector<T> result_;
+    // returns false as well if no task finished in time, Remaining tells
+    // both cases apart
+    bool Next(std::pair<size_t, T>* next, int64_t microseconds) {
+        Clock::time_point deadline = Clock::now() + std::chrono::microseconds(microseconds);
+        LockGuard<Lock> guard(state_->mutex);
+        ++state_->waiting_streamers;
+        while (state_->completed.empty() && !state_->Exhausted()) {
+            if (!state_->WaitUntil(deadline)) {
+                break;
+            }
+        }
+        --state_->waiting_streamers;
+        return state_->PopCompleted(next);
+    }
+
+    // results not handed out by Next yet, skipped tasks excluded
+    size_t Remaining() const {
+        LockGuard<Lock> guard(state_->mutex);
+        if (state_->taken) {
+            return 0;
+        }
+        return state_->num_tasks - state_->streamed - state_->skipped;
+    }
+
+    void Cancel() {
+        state_->token.Cancel();
+    }
+
+    bool IsCancelled() const {
+        return state_->token.IsCancelled();
+    }
+
+    // to be captured by tasks that want to notice a cancellation
+    CancellationToken Token() const {
+        return state_->token;
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct State {
+        State(size_t task_count, CancellationToken&& t)
+            : done(task_count == 0),
+              mutex(),
+              cond(mutex),
+              finish_num(0),
+              num_tasks(task_count),
+              streamed(0),
+              skipped(0),
+              waiting_streamers(0),
+              taken(false),
+              result(task_count),
+              token(std::move(t)) {
+        }
+
+        // every result slot is only written by its own task
+        void RunInThread(const Task& task, size_t index) {
+            bool run = !token.IsCancelled();
+            if (run) {
+                result[index] = task();
+            }
+            LockGuard<Lock> guard(mutex);
+            if (run) {
+                completed.push_back(index);
+            } else {
+                ++skipped;
+            }
+            done = ++finish_num == num_tasks;
+            // Get only cares about the last task, Next about every one
+            if (done || waiting_streamers > 0) {
+                cond.NotifyAll();
+            }
+        }
+
+        // mutex held, returns false once deadline passed
+        bool WaitUntil(Clock::time_point deadline) {
+            int64_t microseconds = std::chrono::duration_cast<std::chrono::microseconds>(
+                    deadline - Clock::now()).count();
+            return microseconds > 0 && !cond.TimedWaitMicroseconds(microseconds);
+        }
+
+        bool Exhausted() const {
+            return taken || streamed + skipped == num_tasks;
+        }
+
+        bool PopCompleted(std::pair<size_t, T>* next) {
+            if (taken || completed.empty()) {
+                return false;
+            }
+            size_t index = completed.front();
+            completed.pop_front();
+            ++streamed;
+            next->first = index;
+            next->second = std::move(result[index]);
+            return true;
+        }
+
+        bool done;
+        mutable Lock mutex;
+        typename ConditionOf<Lock>::type cond;
+        size_t finish_num;
+        const size_t num_tasks;
+        // indices of finished tasks not handed out by Next yet
+        std::deque<size_t> completed;
+        size_t streamed;
+        size_t skipped;
+        // Next callers blocked on cond
+        size_t waiting_streamers;
+        // set by Take, result is empty from then on
+        bool taken;
+        std::vector<T> result;
+        CancellationToken token;
+    };
+
+    std::shared_ptr<State> state_;
 };
 
 } // namespace arcane
@@ -5,6 +5,7 @@
 #include <pthread.h>
 
 #include <arcane/thread_utils.h>
+#include <arcane/lock_profiler.h>
 
 namespace arcane {
 
@@ -23,7 +24,17 @@ public:
     Mutex& operator=(const Mutex&) = delete;
 
     void Lock() {
+#ifdef ARCANE_LOCK_PROFILING
+        if (LockProfiler::IsEnabled()) {
+            LockProfiler::ProfiledLock(this, profile_,
+                                       [this]() { return pthread_mutex_trylock(&mutex_) == 0; },
+                                       [this]() { pthread_mutex_lock(&mutex_); });
+        } else {
+            pthread_mutex_lock(&mutex_);
+        }
+#else
         pthread_mutex_lock(&mutex_);
+#endif
         SetHolder();
     }
 
@@ -37,6 +48,14 @@ public:
 
     void Unlock() {
         ResetHolder();
+#ifdef ARCANE_LOCK_PROFILING
+        if (profile_.acquired_at != 0) {
+            detail::LockProfileSlot done = LockProfiler::Finish(profile_);
+            pthread_mutex_unlock(&mutex_);
+            LockProfiler::GetInstance().Record("Mutex", done);
+            return;
+        }
+#endif
         pthread_mutex_unlock(&mutex_);
     }
 
@@ -60,10 +79,27 @@ private:
         ConditionGuard(Mutex& mutex) 
             : cond_mutex_(mutex) {
             cond_mutex_.ResetHolder();
+#ifdef ARCANE_LOCK_PROFILING
+            // the wait is neither hold time nor contention
+            if (cond_mutex_.profile_.acquired_at != 0) {
+                done_ = LockProfiler::Finish(cond_mutex_.profile_);
+            }
+#endif
         }
 
         ~ConditionGuard() {
             cond_mutex_.SetHolder();
+#ifdef ARCANE_LOCK_PROFILING
+            if (done_.acquired_at != 0) {
+                LockProfiler::GetInstance().Record("Mutex", done_);
+                if (LockProfiler::IsEnabled()) {
+                    done_.acquired_at = LockProfiler::Now();
+                    done_.wait = 0;
+                    done_.contended = false;
+                    cond_mutex_.profile_ = done_;
+                }
+            }
+#endif
         }
 
         ConditionGuard(const ConditionGuard&) = delete;
@@ -71,6 +107,9 @@ private:
 
     private:
         Mutex& cond_mutex_;
+#ifdef ARCANE_LOCK_PROFILING
+        detail::LockProfileSlot done_;
+#endif
     };
 
     void SetHolder() {
@@ -83,8 +122,17 @@ private:
 
     pthread_mutex_t mutex_;
     int64_t holder_;
+#ifdef ARCANE_LOCK_PROFILING
+    detail::LockProfileSlot profile_;
+#endif
 };
 
+#ifdef ARCANE_LOCK_PROFILING
+template <>
+struct IsProfiledLock<Mutex> : std::true_type {
+};
+#endif
+
 } // namespace arcane
 
 #endif
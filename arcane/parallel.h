@@ -0,0 +1,142 @@
+#ifndef ARCANE_PARALLEL_H
+#define ARCANE_PARALLEL_H
+
+#include <stdint.h>
+#include <limits.h>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <iterator>
+#include <algorithm>
+#include <utility>
+
+#include <arcane/futex.h>
+#include <arcane/unique_task.h>
+
+namespace arcane {
+
+namespace detail {
+
+// Shared by the caller and the helper tasks of one parallel loop. Chunks are
+// claimed from next_chunk, so fast threads take more of them, and pending
+// counts the chunks not finished yet, the caller sleeps on it at the end.
+// Helpers starting after the loop is done find no chunk and leave.
+struct ParallelLoop {
+    ParallelLoop(size_t n, size_t chunk)
+        : size(n),
+          chunk_size(chunk),
+          num_chunks((n + chunk - 1) / chunk),
+          next_chunk(0),
+          pending(static_cast<uint32_t>(num_chunks)) {
+    }
+
+    // calls func(chunk_index, chunk_begin, chunk_end) until no chunk is left
+    template <typename Func>
+    void Run(Func& func) {
+        while (true) {
+            size_t chunk = next_chunk.fetch_add(1, std::memory_order_relaxed);
+            if (chunk >= num_chunks) {
+                return;
+            }
+            size_t begin = chunk * chunk_size;
+            func(chunk, begin, std::min(begin + chunk_size, size));
+            if (pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                FutexWake(&pending, INT_MAX);
+            }
+        }
+    }
+
+    void Wait() {
+        uint32_t remaining = pending.load(std::memory_order_acquire);
+        while (remaining != 0) {
+            FutexWait(&pending, remaining);
+            remaining = pending.load(std::memory_order_acquire);
+        }
+    }
+
+    const size_t size;
+    const size_t chunk_size;
+    const size_t num_chunks;
+    std::atomic<size_t> next_chunk;
+    std::atomic<uint32_t> pending;
+};
+
+// grain is the minimal chunk, 0 picks one giving every thread (the caller
+// included) about 4 chunks to balance uneven work.
+inline size_t ParallelChunkSize(size_t n, size_t num_threads, size_t grain) {
+    constexpr const size_t kChunksPerThread = 4;
+    size_t chunk = n / ((num_threads + 1) * kChunksPerThread);
+    chunk = std::max(chunk, std::max(grain, static_cast<size_t>(1)));
+    // pending is a 32 bit futex word
+    return std::max(chunk, n / UINT32_MAX + 1);
+}
+
+template <typename Pool>
+std::shared_ptr<ParallelLoop> MakeParallelLoop(Pool& pool, size_t n, size_t grain) {
+    return std::make_shared<ParallelLoop>(n, ParallelChunkSize(n, pool.NumThreads(), grain));
+}
+
+template <typename Pool, typename Func>
+void ParallelRun(Pool& pool, const std::shared_ptr<ParallelLoop>& loop, Func& func) {
+    if (loop->num_chunks == 0) {
+        return;
+    }
+    size_t num_helpers = std::min(pool.NumThreads(), loop->num_chunks - 1);
+    if (num_helpers > 0) {
+        Func* f = &func;
+        std::vector<UniqueTask> helpers;
+        helpers.reserve(num_helpers);
+        for (size_t i = 0; i < num_helpers; ++i) {
+            helpers.emplace_back([loop, f]() {
+                loop->Run(*f);
+            });
+        }
+        pool.RunTasks(std::make_move_iterator(helpers.begin()),
+                      std::make_move_iterator(helpers.end()));
+    }
+    loop->Run(func);
+    loop->Wait();
+}
+
+} // namespace detail
+
+// Calls fn(chunk_begin, chunk_end) over consecutive chunks of [begin, end)
+// on the pool, the calling thread works on chunks too instead of blocking
+// and returns once every chunk is done. It is therefore safe to call from a
+// pool thread. Index is an integer or a random access iterator.
+template <typename Pool, typename Index, typename Func>
+void ParallelFor(Pool& pool, Index begin, Index end, size_t grain, Func fn) {
+    auto func = [begin, &fn](size_t, size_t chunk_begin, size_t chunk_end) {
+        fn(begin + chunk_begin, begin + chunk_end);
+    };
+    detail::ParallelRun(pool, detail::MakeParallelLoop(pool, end - begin, grain), func);
+}
+
+// Reduces [begin, end) to combine(...combine(combine(identity, map(chunk0)),
+// map(chunk1))...), where map(chunk_begin, chunk_end) returns the partial
+// result of a chunk. Partials are combined by the caller in chunk order, so
+// the result does not depend on scheduling.
+template <typename Pool, typename Index, typename T, typename Map, typename Combine>
+T ParallelReduce(Pool& pool,
+                 Index begin,
+                 Index end,
+                 size_t grain,
+                 T identity,
+                 Map map,
+                 Combine combine) {
+    std::shared_ptr<detail::ParallelLoop> loop = detail::MakeParallelLoop(pool, end - begin, grain);
+    std::vector<T> partials(loop->num_chunks, identity);
+    auto func = [begin, &map, &partials](size_t chunk, size_t chunk_begin, size_t chunk_end) {
+        partials[chunk] = map(begin + chunk_begin, begin + chunk_end);
+    };
+    detail::ParallelRun(pool, loop, func);
+    T result = std::move(identity);
+    for (auto& partial : partials) {
+        result = combine(std::move(result), std::move(partial));
+    }
+    return result;
+}
+
+} // namespace arcane
+
+#endif
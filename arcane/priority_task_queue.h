@@ -0,0 +1,194 @@
+#ifndef ARCANE_PRIORITY_TASK_QUEUE_H
+#define ARCANE_PRIORITY_TASK_QUEUE_H
+
+#include <stdint.h>
+#include <atomic>
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <vector>
+#include <utility>
+
+#include <arcane/unique_task.h>
+
+namespace arcane {
+
+enum class TaskPriority {
+    kHigh = 0,
+    kNormal = 1,
+    kLow = 2,
+};
+
+// A task tagged with its priority, ThreadPool::RunTask(task, priority)
+// submits it. PriorityTaskQueue sorts it into its lane, any other queue
+// just runs it.
+struct PriorityTask {
+    PriorityTask(UniqueTask&& t, TaskPriority p)
+        : task(std::move(t)),
+          priority(p) {
+    }
+
+    void operator()() {
+        task();
+    }
+
+    UniqueTask task;
+    TaskPriority priority;
+};
+
+// A task to be dropped instead of run once its deadline passed, submitted
+// by ThreadPool::RunTask(task, deadline). PriorityTaskQueue runs these
+// earliest deadline first, any other queue in its own order.
+struct DeadlineTask {
+    using Clock = std::chrono::steady_clock;
+
+    DeadlineTask(UniqueTask&& t, Clock::time_point d, std::atomic<size_t>* dropped_counter)
+        : task(std::move(t)),
+          deadline(d),
+          dropped(dropped_counter) {
+    }
+
+    void operator()() {
+        if (Clock::now() > deadline) {
+            ++*dropped;
+        } else {
+            task();
+        }
+    }
+
+    UniqueTask task;
+    Clock::time_point deadline;
+    std::atomic<size_t>* dropped;
+};
+
+// Queue for ThreadPool<PriorityTaskQueue> serving tasks with a deadline
+// first, earliest deadline first, then high, normal and low priority
+// tasks, each lane in FIFO order. Plain tasks go to the normal lane. A lane
+// passed over kMaxSkips times in a row while it had tasks is served next,
+// so a flood of urgent work slows the rest down but never stops it.
+// Tasks whose deadline passed are dropped when they reach the front.
+//
+// Like std::deque it is guarded by the pool mutex.
+class PriorityTaskQueue {
+public:
+    static constexpr const size_t kMaxSkips = 16;
+
+    PriorityTaskQueue()
+        : size_(0),
+          sequence_(0),
+          skips_() {
+    }
+
+    PriorityTaskQueue(const PriorityTaskQueue&) = delete;
+    PriorityTaskQueue& operator=(const PriorityTaskQueue&) = delete;
+
+    template <typename F>
+    void emplace_back(F&& f) {
+        lanes_[static_cast<size_t>(TaskPriority::kNormal)].emplace_back(std::forward<F>(f));
+        ++size_;
+    }
+
+    void emplace_back(PriorityTask&& task) {
+        lanes_[static_cast<size_t>(task.priority)].emplace_back(std::move(task.task));
+        ++size_;
+    }
+
+    void emplace_back(DeadlineTask&& task) {
+        deadlines_.push_back(Entry{task.deadline, sequence_++, std::move(task.task), task.dropped});
+        std::push_heap(deadlines_.begin(), deadlines_.end(), Later);
+        ++size_;
+    }
+
+    // an expired task is handed out empty, the pool skips it
+    UniqueTask& front() {
+        size_t lane = Select();
+        if (lane == kDeadlineLane) {
+            Entry& entry = deadlines_.front();
+            if (entry.task && DeadlineTask::Clock::now() > entry.deadline) {
+                entry.task = nullptr;
+                ++*entry.dropped;
+            }
+            return entry.task;
+        }
+        return lanes_[lane - 1].front();
+    }
+
+    void pop_front() {
+        size_t lane = Select();
+        if (lane == kDeadlineLane) {
+            std::pop_heap(deadlines_.begin(), deadlines_.end(), Later);
+            deadlines_.pop_back();
+        } else {
+            lanes_[lane - 1].pop_front();
+        }
+        --size_;
+        for (size_t i = 0; i < kNumLanes; ++i) {
+            if (i == lane || LaneEmpty(i)) {
+                skips_[i] = 0;
+            } else if (i > lane) {
+                ++skips_[i];
+            }
+        }
+    }
+
+    bool empty() const {
+        return size_ == 0;
+    }
+
+    size_t size() const {
+        return size_;
+    }
+
+private:
+    static constexpr const size_t kNumPriorities = 3;
+    // lane 0 holds the deadline tasks, lane 1 + priority the others
+    static constexpr const size_t kNumLanes = kNumPriorities + 1;
+    static constexpr const size_t kDeadlineLane = 0;
+
+    struct Entry {
+        DeadlineTask::Clock::time_point deadline;
+        // keeps equal deadlines in submission order
+        uint64_t sequence;
+        UniqueTask task;
+        std::atomic<size_t>* dropped;
+    };
+
+    static bool Later(const Entry& a, const Entry& b) {
+        if (a.deadline != b.deadline) {
+            return a.deadline > b.deadline;
+        }
+        return a.sequence > b.sequence;
+    }
+
+    bool LaneEmpty(size_t lane) const {
+        return lane == kDeadlineLane ? deadlines_.empty() : lanes_[lane - 1].empty();
+    }
+
+    // the most urgent lane with tasks unless a lower one starves
+    size_t Select() const {
+        size_t selected = kNumLanes;
+        for (size_t i = 0; i < kNumLanes; ++i) {
+            if (LaneEmpty(i)) {
+                continue;
+            }
+            if (selected == kNumLanes) {
+                selected = i;
+            }
+            if (skips_[i] >= kMaxSkips) {
+                selected = i;
+                break;
+            }
+        }
+        return selected;
+    }
+
+    size_t size_;
+    uint64_t sequence_;
+    std::vector<Entry> deadlines_;
+    std::deque<UniqueTask> lanes_[kNumPriorities];
+    size_t skips_[kNumLanes];
+};
+
+} // namespace arcane
+
+#endif
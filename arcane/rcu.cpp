@@ -0,0 +1,197 @@
+
+#include <arcane/rcu.h>
+
+#include <sched.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#ifdef __NR_membarrier
+#include <linux/membarrier.h>
+#endif
+
+namespace arcane {
+
+namespace detail {
+
+std::atomic<uint64_t> g_next_epoch_domain_id(1);
+
+bool RegisterMembarrier() {
+#ifdef __NR_membarrier
+    long commands = syscall(__NR_membarrier, MEMBARRIER_CMD_QUERY, 0, 0);
+    if (commands < 0 || !(commands & MEMBARRIER_CMD_PRIVATE_EXPEDITED)) {
+        return false;
+    }
+    return syscall(__NR_membarrier, MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED, 0, 0) == 0;
+#else
+    return false;
+#endif
+}
+
+bool UseMembarrier() {
+    static const bool use_membarrier = RegisterMembarrier();
+    return use_membarrier;
+}
+
+} // namespace detail
+
+// Records of all domains the thread read in. They are shared with their
+// domain so that either side may go away first, the thread gives them
+// back when it exits.
+class EpochDomain::LocalRecords {
+public:
+    ~LocalRecords() {
+        for (auto& entry : records) {
+            entry.second->nesting = 0;
+            entry.second->epoch.store(kQuiescent, std::memory_order_release);
+            entry.second->in_use.store(false, std::memory_order_release);
+        }
+        LocalCache() = {0, nullptr};
+    }
+
+    static LocalRecords& Get() {
+        static thread_local LocalRecords t_records;
+        return t_records;
+    }
+
+    std::vector<std::pair<uint64_t, std::shared_ptr<ThreadRecord>>> records;
+};
+
+EpochDomain::EpochDomain()
+    : id_(detail::g_next_epoch_domain_id.fetch_add(1)),
+      use_membarrier_(detail::UseMembarrier()),
+      epoch_(1) {
+}
+
+EpochDomain::~EpochDomain() {
+    // no reader is left, whatever is retired can go
+    for (auto& retired : retired_) {
+        retired.deleter();
+    }
+}
+
+EpochDomain& EpochDomain::Default() {
+    static EpochDomain domain;
+    return domain;
+}
+
+EpochDomain::ThreadRecord* EpochDomain::LocalRecordSlow() {
+    LocalRecords& local = LocalRecords::Get();
+    std::shared_ptr<ThreadRecord> record;
+    for (auto& entry : local.records) {
+        if (entry.first == id_) {
+            record = entry.second;
+            break;
+        }
+    }
+    if (!record) {
+        LockGuard<Mutex> guard(records_mutex_);
+        for (auto& candidate : records_) {
+            bool in_use = false;
+            if (candidate->in_use.compare_exchange_strong(in_use, true)) {
+                record = candidate;
+                break;
+            }
+        }
+        if (!record) {
+            record = std::make_shared<ThreadRecord>();
+            records_.push_back(record);
+        }
+        local.records.emplace_back(id_, record);
+    }
+    LocalCache() = {id_, record.get()};
+    return record.get();
+}
+
+void EpochDomain::Retire(UniqueTask&& deleter) {
+    bool reclaim = false;
+    {
+        LockGuard<Mutex> guard(retired_mutex_);
+        retired_.push_back(Retired{epoch_.load(), std::move(deleter)});
+        reclaim = retired_.size() >= kReclaimThreshold;
+    }
+    if (reclaim) {
+        Reclaim();
+    }
+}
+
+void EpochDomain::Reclaim() {
+    std::vector<UniqueTask> ready;
+    std::function<void (UniqueTask&&)> executor;
+    {
+        LockGuard<Mutex> guard(retired_mutex_);
+        if (retired_.empty()) {
+            return;
+        }
+        // a reader that started in a later epoch than an object's retirement
+        // cannot have seen the object
+        uint64_t min_active = MinActiveEpoch();
+        size_t kept = 0;
+        for (auto& retired : retired_) {
+            if (retired.epoch < min_active) {
+                ready.push_back(std::move(retired.deleter));
+            } else {
+                retired_[kept++] = std::move(retired);
+            }
+        }
+        retired_.resize(kept);
+        executor = reclaim_executor_;
+    }
+    if (ready.empty()) {
+        return;
+    }
+    if (executor) {
+        executor([ready = std::move(ready)]() mutable {
+            for (auto& deleter : ready) {
+                deleter();
+            }
+        });
+    } else {
+        for (auto& deleter : ready) {
+            deleter();
+        }
+    }
+}
+
+void EpochDomain::Synchronize() {
+    uint64_t epoch = epoch_.fetch_add(1) + 1;
+    WriterFence();
+    LockGuard<Mutex> guard(records_mutex_);
+    for (auto& record : records_) {
+        uint64_t record_epoch = record->epoch.load(std::memory_order_acquire);
+        while (record_epoch != kQuiescent && record_epoch < epoch) {
+            sched_yield();
+            record_epoch = record->epoch.load(std::memory_order_acquire);
+        }
+    }
+}
+
+size_t EpochDomain::RetiredSize() const {
+    LockGuard<Mutex> guard(retired_mutex_);
+    return retired_.size();
+}
+
+// pairs with ReaderFence: either the reclaimer sees a reader's epoch, or
+// the reader sees what was unpublished before the epoch was advanced
+void EpochDomain::WriterFence() const {
+#ifdef __NR_membarrier
+    if (use_membarrier_) {
+        syscall(__NR_membarrier, MEMBARRIER_CMD_PRIVATE_EXPEDITED, 0, 0);
+        return;
+    }
+#endif
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+uint64_t EpochDomain::MinActiveEpoch() {
+    uint64_t min_active = epoch_.fetch_add(1) + 1;
+    WriterFence();
+    LockGuard<Mutex> guard(records_mutex_);
+    for (auto& record : records_) {
+        uint64_t record_epoch = record->epoch.load(std::memory_order_acquire);
+        if (record_epoch != kQuiescent && record_epoch < min_active) {
+            min_active = record_epoch;
+        }
+    }
+    return min_active;
+}
+
+} // namespace arcane
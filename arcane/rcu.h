@@ -0,0 +1,222 @@
+#ifndef ARCANE_RCU_H
+#define ARCANE_RCU_H
+
+#include <stdint.h>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <functional>
+#include <utility>
+
+#include <arcane/mutex.h>
+#include <arcane/lock_guard.h>
+#include <arcane/unique_task.h>
+
+namespace arcane {
+
+// Epoch based reclamation. Readers announce the global epoch they started
+// in, in a record only their own thread writes; writers unpublish an object
+// and retire it, it is destroyed once every reader that may still see it
+// has left. Where the kernel supports membarrier(2) the fence a reader
+// needs is moved to the reclaiming side, then entering and leaving a read
+// section are plain stores to a thread local cache line.
+//
+// Read sections may nest, they must not block on a writer of the same
+// domain waiting in Synchronize().
+class EpochDomain {
+public:
+    EpochDomain();
+    ~EpochDomain();
+
+    EpochDomain(const EpochDomain&) = delete;
+    EpochDomain& operator=(const EpochDomain&) = delete;
+
+    // process wide domain used by RcuPtr unless told otherwise
+    static EpochDomain& Default();
+
+    void ReadLock() {
+        ThreadRecord* record = LocalRecord();
+        if (record->nesting++ == 0) {
+            record->epoch.store(epoch_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            ReaderFence();
+        }
+    }
+
+    void ReadUnlock() {
+        ThreadRecord* record = LocalRecord();
+        if (--record->nesting == 0) {
+            record->epoch.store(kQuiescent, std::memory_order_release);
+        }
+    }
+
+    // runs deleter once no reader can hold what it frees, the object must
+    // already be unreachable for new readers
+    void Retire(UniqueTask&& deleter);
+
+    template <typename T>
+    void Retire(T* ptr) {
+        Retire([ptr]() {
+            delete ptr;
+        });
+    }
+
+    // runs retired deleters that became safe, on the pool if one is set
+    void Reclaim();
+
+    // blocks until all read sections active at the call have finished
+    void Synchronize();
+
+    // deleters run as tasks of pool from now on, pool must outlive the
+    // domain or be stopped before it
+    template <typename Pool>
+    void SetReclaimPool(Pool& pool) {
+        LockGuard<Mutex> guard(retired_mutex_);
+        reclaim_executor_ = [&pool](UniqueTask&& task) {
+            pool.RunTask(std::move(task));
+        };
+    }
+
+    // retired deleters waiting for readers
+    size_t RetiredSize() const;
+
+private:
+    static constexpr const size_t kCacheLineSize = 64;
+    static constexpr const uint64_t kQuiescent = 0;
+    // a Retire finding this many deleters pending calls Reclaim
+    static constexpr const size_t kReclaimThreshold = 128;
+
+    struct ThreadRecord {
+        ThreadRecord()
+            : epoch(kQuiescent),
+              nesting(0),
+              in_use(true) {
+        }
+
+        // epoch the thread's outermost read section started in
+        std::atomic<uint64_t> epoch;
+        uint32_t nesting;
+        std::atomic<bool> in_use;
+        // keeps neighbouring records off this cache line
+        char padding[kCacheLineSize];
+    };
+
+    struct Retired {
+        uint64_t epoch;
+        UniqueTask deleter;
+    };
+
+    class LocalRecords;
+
+    struct CachedRecord {
+        uint64_t domain_id;
+        ThreadRecord* record;
+    };
+
+    static CachedRecord& LocalCache() {
+        static thread_local CachedRecord t_cache = {0, nullptr};
+        return t_cache;
+    }
+
+    ThreadRecord* LocalRecord() {
+        CachedRecord& cache = LocalCache();
+        if (cache.domain_id == id_) {
+            return cache.record;
+        }
+        return LocalRecordSlow();
+    }
+
+    void ReaderFence() const {
+        if (use_membarrier_) {
+            std::atomic_signal_fence(std::memory_order_seq_cst);
+        } else {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+        }
+    }
+
+    ThreadRecord* LocalRecordSlow();
+    void WriterFence() const;
+    uint64_t MinActiveEpoch();
+
+    // never 0, identifies the domain in thread local caches
+    const uint64_t id_;
+    const bool use_membarrier_;
+    std::atomic<uint64_t> epoch_;
+    mutable Mutex records_mutex_;
+    std::vector<std::shared_ptr<ThreadRecord>> records_;
+    mutable Mutex retired_mutex_;
+    std::vector<Retired> retired_;
+    std::function<void (UniqueTask&&)> reclaim_executor_;
+};
+
+// scoped read section
+class EpochGuard {
+public:
+    explicit EpochGuard(EpochDomain& domain = EpochDomain::Default())
+        : domain_(domain) {
+        domain_.ReadLock();
+    }
+
+    ~EpochGuard() {
+        domain_.ReadUnlock();
+    }
+
+    EpochGuard(const EpochGuard&) = delete;
+    EpochGuard& operator=(const EpochGuard&) = delete;
+
+private:
+    EpochDomain& domain_;
+};
+
+// Pointer to a read-mostly object that is replaced as a whole:
+//     {
+//         EpochGuard guard;
+//         Lookup(table.Get(), key);
+//     }
+//     table.Update(new Table(...));
+// Readers dereference under an EpochGuard of the pointer's domain, the
+// replaced object is retired to the domain.
+template <typename T>
+class RcuPtr {
+public:
+    explicit RcuPtr(T* ptr = nullptr, EpochDomain& domain = EpochDomain::Default())
+        : domain_(domain),
+          ptr_(ptr) {
+    }
+
+    // no reader may be left
+    ~RcuPtr() {
+        delete ptr_.load(std::memory_order_relaxed);
+    }
+
+    RcuPtr(const RcuPtr&) = delete;
+    RcuPtr& operator=(const RcuPtr&) = delete;
+
+    // valid until the enclosing read section ends
+    T* Get() const {
+        return ptr_.load(std::memory_order_acquire);
+    }
+
+    // publishes ptr, the previous object is destroyed once readers left
+    void Update(T* ptr) {
+        T* old = ptr_.exchange(ptr, std::memory_order_seq_cst);
+        if (old != nullptr) {
+            domain_.Retire(old);
+        }
+    }
+
+    void Update(std::unique_ptr<T> ptr) {
+        Update(ptr.release());
+    }
+
+    EpochDomain& Domain() const {
+        return domain_;
+    }
+
+private:
+    EpochDomain& domain_;
+    std::atomic<T*> ptr_;
+};
+
+} // namespace arcane
+
+#endif
@@ -3,6 +3,8 @@
 
 #include <pthread.h>
 
+#include <arcane/lock_profiler.h>
+
 namespace arcane {
 
 class RWLock {
@@ -19,22 +21,89 @@ public:
     RWLock& operator=(const RWLock&) = delete;
 
     void ReadLock() {
+#ifdef ARCANE_LOCK_PROFILING
+        if (LockProfiler::IsEnabled()) {
+            LockProfiler::ProfiledLock(this, LocalReadProfile(),
+                                       [this]() { return pthread_rwlock_tryrdlock(&rwlock_) == 0; },
+                                       [this]() { pthread_rwlock_rdlock(&rwlock_); });
+            return;
+        }
+#endif
         pthread_rwlock_rdlock(&rwlock_);
     }
 
     void WriteLock() {
+#ifdef ARCANE_LOCK_PROFILING
+        if (LockProfiler::IsEnabled()) {
+            LockProfiler::ProfiledLock(this, write_profile_,
+                                       [this]() { return pthread_rwlock_trywrlock(&rwlock_) == 0; },
+                                       [this]() { pthread_rwlock_wrlock(&rwlock_); });
+            return;
+        }
+#endif
         pthread_rwlock_wrlock(&rwlock_);
     }
 
     void Unlock() {
+#ifdef ARCANE_LOCK_PROFILING
+        detail::LockProfileSlot& read_profile = LocalReadProfile();
+        if (read_profile.acquired_at != 0 && read_profile.lock == this) {
+            ReadUnlock();
+        } else {
+            WriteUnlock();
+        }
+#else
+        pthread_rwlock_unlock(&rwlock_);
+#endif
+    }
+
+    void ReadUnlock() {
+#ifdef ARCANE_LOCK_PROFILING
+        detail::LockProfileSlot& read_profile = LocalReadProfile();
+        if (read_profile.acquired_at != 0 && read_profile.lock == this) {
+            detail::LockProfileSlot done = LockProfiler::Finish(read_profile);
+            pthread_rwlock_unlock(&rwlock_);
+            LockProfiler::GetInstance().Record("RWLock read", done);
+            return;
+        }
+#endif
+        pthread_rwlock_unlock(&rwlock_);
+    }
+
+    void WriteUnlock() {
+#ifdef ARCANE_LOCK_PROFILING
+        if (write_profile_.acquired_at != 0) {
+            detail::LockProfileSlot done = LockProfiler::Finish(write_profile_);
+            pthread_rwlock_unlock(&rwlock_);
+            LockProfiler::GetInstance().Record("RWLock write", done);
+            return;
+        }
+#endif
         pthread_rwlock_unlock(&rwlock_);
     }
 
 private:
+#ifdef ARCANE_LOCK_PROFILING
+    // readers share the lock, a read acquisition is kept by the thread, of
+    // nested read locks only the innermost one is profiled
+    static detail::LockProfileSlot& LocalReadProfile() {
+        static thread_local detail::LockProfileSlot t_profile;
+        return t_profile;
+    }
+#endif
+
     pthread_rwlock_t rwlock_;
+#ifdef ARCANE_LOCK_PROFILING
+    detail::LockProfileSlot write_profile_;
+#endif
 };
 
+#ifdef ARCANE_LOCK_PROFILING
+template <>
+struct IsProfiledLock<RWLock> : std::true_type {
+};
+#endif
+
 } // namespace arcane
 
 #endif
-
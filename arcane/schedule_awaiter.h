@@ -0,0 +1,37 @@
+#ifndef ARCANE_SCHEDULE_AWAITER_H
+#define ARCANE_SCHEDULE_AWAITER_H
+
+#include <coroutine>
+
+namespace arcane {
+
+// co_await pool.Schedule() suspends the coroutine and resumes it on a
+// thread of pool. A pool without threads resumes it in place, a stopped
+// pool drops it, the coroutine is never resumed then.
+template <typename Pool>
+class ScheduleAwaiter {
+public:
+    explicit ScheduleAwaiter(Pool& pool)
+        : pool_(pool) {
+    }
+
+    bool await_ready() const noexcept {
+        return false;
+    }
+
+    void await_suspend(std::coroutine_handle<> handle) {
+        pool_.Emplace([handle]() {
+            handle.resume();
+        });
+    }
+
+    void await_resume() const noexcept {
+    }
+
+private:
+    Pool& pool_;
+};
+
+} // namespace arcane
+
+#endif
@@ -0,0 +1,156 @@
+#ifndef ARCANE_SEQLOCK_H
+#define ARCANE_SEQLOCK_H
+
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+#include <type_traits>
+
+#include <arcane/thread_utils.h>
+
+namespace arcane {
+
+template <typename T>
+class SeqLockWriteGuard;
+
+// Publishes a small trivially copyable T to many readers. A writer makes
+// the sequence number odd, stores the value and makes it even again; a
+// reader copies the value out and retries if the sequence changed in
+// between. Readers never write shared memory, so they do not slow each
+// other down, and writers never wait for readers. Concurrent writers are
+// serialized on the sequence number.
+//
+// The value is kept in atomic words so that a reader racing with a writer
+// is well defined, its torn copy is simply thrown away.
+template <typename T>
+class SeqLock {
+public:
+    static_assert(std::is_trivially_copyable<T>::value, "SeqLock needs a trivially copyable T");
+    static_assert(std::is_default_constructible<T>::value, "SeqLock needs a default constructible T");
+
+    SeqLock()
+        : SeqLock(T()) {
+    }
+
+    explicit SeqLock(const T& value)
+        : sequence_(0) {
+        StoreWords(value);
+    }
+
+    SeqLock(const SeqLock&) = delete;
+    SeqLock& operator=(const SeqLock&) = delete;
+
+    T Load() const {
+        uint64_t words[kWords];
+        while (true) {
+            uint64_t sequence = sequence_.load(std::memory_order_acquire);
+            if (sequence & 1) {
+                CpuRelax();
+                continue;
+            }
+            for (size_t i = 0; i < kWords; ++i) {
+                words[i] = words_[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence_.load(std::memory_order_relaxed) == sequence) {
+                break;
+            }
+        }
+        T value;
+        memcpy(&value, words, sizeof(T));
+        return value;
+    }
+
+    void Store(const T& value) {
+        WriteLock();
+        StoreWords(value);
+        WriteUnlock();
+    }
+
+    // brackets a write section, readers retry until WriteUnlock
+    void WriteLock() {
+        uint64_t sequence = sequence_.load(std::memory_order_relaxed);
+        while (true) {
+            if (sequence & 1) {
+                CpuRelax();
+                sequence = sequence_.load(std::memory_order_relaxed);
+            } else if (sequence_.compare_exchange_weak(sequence, sequence + 1,
+                                                       std::memory_order_acquire,
+                                                       std::memory_order_relaxed)) {
+                break;
+            }
+        }
+        // the odd sequence must be visible before any of the new words
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    void WriteUnlock() {
+        sequence_.fetch_add(1, std::memory_order_release);
+    }
+
+private:
+    friend class SeqLockWriteGuard<T>;
+
+    static constexpr const size_t kWords = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    // only called by the writer holding the sequence
+    T LoadWords() const {
+        uint64_t words[kWords];
+        for (size_t i = 0; i < kWords; ++i) {
+            words[i] = words_[i].load(std::memory_order_relaxed);
+        }
+        T value;
+        memcpy(&value, words, sizeof(T));
+        return value;
+    }
+
+    void StoreWords(const T& value) {
+        uint64_t words[kWords] = {0};
+        memcpy(words, &value, sizeof(T));
+        for (size_t i = 0; i < kWords; ++i) {
+            words_[i].store(words[i], std::memory_order_relaxed);
+        }
+    }
+
+    std::atomic<uint64_t> sequence_;
+    std::atomic<uint64_t> words_[kWords];
+};
+
+// Write section updating the value in place:
+//     SeqLockWriteGuard<Config> guard(config);
+//     guard->level = 3;
+// The modified copy is published when the guard goes out of scope. Store()
+// is enough to replace the value as a whole.
+template <typename T>
+class SeqLockWriteGuard {
+public:
+    explicit SeqLockWriteGuard(SeqLock<T>& lock)
+        : lock_(lock) {
+        lock_.WriteLock();
+        value_ = lock_.LoadWords();
+    }
+
+    ~SeqLockWriteGuard() {
+        lock_.StoreWords(value_);
+        lock_.WriteUnlock();
+    }
+
+    SeqLockWriteGuard(const SeqLockWriteGuard&) = delete;
+    SeqLockWriteGuard& operator=(const SeqLockWriteGuard&) = delete;
+
+    T& operator*() {
+        return value_;
+    }
+
+    T* operator->() {
+        return &value_;
+    }
+
+private:
+    SeqLock<T>& lock_;
+    T value_;
+};
+
+} // namespace arcane
+
+#endif
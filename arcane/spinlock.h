@@ -5,6 +5,7 @@
 #include <pthread.h>
 
 #include <arcane/thread_utils.h>
+#include <arcane/lock_profiler.h>
 
 namespace arcane {
 
@@ -23,12 +24,30 @@ public:
     SpinLock& operator=(const SpinLock&) = delete;
 
     void Lock() {
+#ifdef ARCANE_LOCK_PROFILING
+        if (LockProfiler::IsEnabled()) {
+            LockProfiler::ProfiledLock(this, profile_,
+                                       [this]() { return pthread_spin_trylock(&spin_) == 0; },
+                                       [this]() { pthread_spin_lock(&spin_); });
+        } else {
+            pthread_spin_lock(&spin_);
+        }
+#else
         pthread_spin_lock(&spin_);
+#endif
         SetHolder();
     }
 
     void Unlock() {
         ResetHolder();
+#ifdef ARCANE_LOCK_PROFILING
+        if (profile_.acquired_at != 0) {
+            detail::LockProfileSlot done = LockProfiler::Finish(profile_);
+            pthread_spin_unlock(&spin_);
+            LockProfiler::GetInstance().Record("SpinLock", done);
+            return;
+        }
+#endif
         pthread_spin_unlock(&spin_);
     }
 
@@ -51,8 +70,17 @@ private:
 
     pthread_spinlock_t spin_;
     int64_t holder_;
+#ifdef ARCANE_LOCK_PROFILING
+    detail::LockProfileSlot profile_;
+#endif
 };
 
+#ifdef ARCANE_LOCK_PROFILING
+template <>
+struct IsProfiledLock<SpinLock> : std::true_type {
+};
+#endif
+
 } // namespace arcane
 
 #endif
@@ -0,0 +1,195 @@
+#ifndef ARCANE_STRAND_H
+#define ARCANE_STRAND_H
+
+#include <stdint.h>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+
+#include <arcane/thread_pool.h>
+#include <arcane/mutex.h>
+#include <arcane/lock_guard.h>
+
+namespace arcane {
+
+namespace detail {
+
+// tasks of one strand, at most one drain of them is queued in the pool
+struct SerialQueue {
+    SerialQueue()
+        : running(false) {
+    }
+
+    std::deque<ThreadPoolTask> tasks;
+    bool running;
+};
+
+// a drain runs this many tasks before it gives the pool thread back to
+// others, so that one busy strand does not starve the rest
+constexpr const size_t kStrandBatchSize = 64;
+
+} // namespace detail
+
+// Runs tasks posted to it one at a time in posting order on a shared pool,
+// without a lock held while a task runs. Pool threads are never blocked by
+// the serialization: a strand with pending work has one drain task queued
+// in the pool, further tasks are queued in the strand.
+//
+// Tasks keep the strand's state alive, the Strand may be destroyed with
+// tasks pending. Pool is any executor providing Emplace().
+template <typename Pool = ThreadPool<>>
+class Strand {
+public:
+    explicit Strand(Pool& pool)
+        : state_(std::make_shared<State>(pool)) {
+    }
+
+    Strand(const Strand&) = delete;
+    Strand& operator=(const Strand&) = delete;
+
+    template <typename F>
+    void Post(F&& f) {
+        std::shared_ptr<State> state = state_;
+        {
+            LockGuard<Mutex> guard(state->mutex);
+            state->queue.tasks.emplace_back(std::forward<F>(f));
+            if (state->queue.running) {
+                return;
+            }
+            state->queue.running = true;
+        }
+        Schedule(state);
+    }
+
+    // tasks waiting to run
+    size_t Size() const {
+        LockGuard<Mutex> guard(state_->mutex);
+        return state_->queue.tasks.size();
+    }
+
+private:
+    struct State {
+        explicit State(Pool& p)
+            : pool(p) {
+        }
+
+        Pool& pool;
+        Mutex mutex;
+        detail::SerialQueue queue;
+    };
+
+    static void Schedule(const std::shared_ptr<State>& state) {
+        state->pool.Emplace([state]() {
+            Drain(state);
+        });
+    }
+
+    static void Drain(const std::shared_ptr<State>& state) {
+        for (size_t i = 0; i < detail::kStrandBatchSize; ++i) {
+            ThreadPoolTask task;
+            {
+                LockGuard<Mutex> guard(state->mutex);
+                if (state->queue.tasks.empty()) {
+                    state->queue.running = false;
+                    return;
+                }
+                task = std::move(state->queue.tasks.front());
+                state->queue.tasks.pop_front();
+            }
+            task();
+        }
+        Schedule(state);
+    }
+
+    std::shared_ptr<State> state_;
+};
+
+// A strand per key, created on the first Post for a key and dropped once
+// its tasks ran out: tasks of one key run one at a time in posting order,
+// tasks of different keys run in parallel. Keys are spread over shards so
+// that posting for different keys rarely meets on a lock.
+//
+// The executor must outlive the tasks posted to it, stop the pool first.
+template <typename Key, typename Pool = ThreadPool<>, typename Hash = std::hash<Key>>
+class KeyedExecutor {
+public:
+    explicit KeyedExecutor(Pool& pool, size_t num_shards = 16)
+        : pool_(pool),
+          num_shards_(num_shards),
+          shards_(new Shard[num_shards]) {
+    }
+
+    KeyedExecutor(const KeyedExecutor&) = delete;
+    KeyedExecutor& operator=(const KeyedExecutor&) = delete;
+
+    template <typename F>
+    void Post(const Key& key, F&& f) {
+        Shard& shard = shards_[Hash()(key) % num_shards_];
+        detail::SerialQueue* queue = nullptr;
+        {
+            LockGuard<Mutex> guard(shard.mutex);
+            queue = &shard.queues[key];
+            queue->tasks.emplace_back(std::forward<F>(f));
+            if (queue->running) {
+                return;
+            }
+            queue->running = true;
+        }
+        Schedule(&shard, key);
+    }
+
+    // keys with tasks pending or running
+    size_t NumActiveKeys() const {
+        size_t num = 0;
+        for (size_t i = 0; i < num_shards_; ++i) {
+            LockGuard<Mutex> guard(shards_[i].mutex);
+            num += shards_[i].queues.size();
+        }
+        return num;
+    }
+
+private:
+    struct Shard {
+        mutable Mutex mutex;
+        std::unordered_map<Key, detail::SerialQueue, Hash> queues;
+    };
+
+    void Schedule(Shard* shard, const Key& key) {
+        pool_.Emplace([this, shard, key]() {
+            Drain(shard, key);
+        });
+    }
+
+    // only the drain of a key erases its queue, the node stays put until then
+    void Drain(Shard* shard, const Key& key) {
+        detail::SerialQueue* queue = nullptr;
+        {
+            LockGuard<Mutex> guard(shard->mutex);
+            queue = &shard->queues.find(key)->second;
+        }
+        for (size_t i = 0; i < detail::kStrandBatchSize; ++i) {
+            ThreadPoolTask task;
+            {
+                LockGuard<Mutex> guard(shard->mutex);
+                if (queue->tasks.empty()) {
+                    shard->queues.erase(key);
+                    return;
+                }
+                task = std::move(queue->tasks.front());
+                queue->tasks.pop_front();
+            }
+            task();
+        }
+        Schedule(shard, key);
+    }
+
+    Pool& pool_;
+    const size_t num_shards_;
+    std::unique_ptr<Shard[]> shards_;
+};
+
+} // namespace arcane
+
+#endif
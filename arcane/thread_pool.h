@@ -6,21 +6,36 @@
 #include <string>
 #include <vector>
 #include <deque>
-#include <functional>
 #include <thread>
 #include <memory>
+#include <mutex>
+#include <utility>
+#include <atomic>
 #include <exception>
+#include <chrono>
+#include <type_traits>
 
 #include <arcane/mutex.h>
 #include <arcane/condition.h>
+#include <arcane/futex_mutex.h>
 #include <arcane/lock_guard.h>
 #include <arcane/log.h>
+#include <arcane/schedule_awaiter.h>
+#include <arcane/timer_wheel.h>
+#include <arcane/mpmc_queue.h>
+#include <arcane/priority_task_queue.h>
+#include <arcane/unique_task.h>
 
 namespace arcane {
 
-using ThreadPoolTask = std::function<void ()>;
+using ThreadPoolTask = UniqueTask;
 
-template <typename Queue = std::deque<ThreadPoolTask>>
+// Queue is either a container guarded by the pool mutex (std::deque by
+// default) or a lock-free queue such as BoundedMpmcQueue<ThreadPoolTask>,
+// which keeps the mutex off the fast path and only uses it to sleep when
+// the queue is empty or full. PriorityTaskQueue orders tasks by priority and
+// deadline. Lock is the pool mutex, Mutex or FutexMutex<>.
+template <typename Queue = std::deque<ThreadPoolTask>, typename Lock = Mutex>
 class ThreadPool {
 public:
     using Task = ThreadPoolTask;
@@ -30,8 +45,12 @@ public:
           mutex_(),
           not_empty_(mutex_),
           not_full_(mutex_),
+          idle_threads_(0),
+          waiting_producers_(0),
+          dropped_tasks_(0),
           num_threads_(num_threads),
           max_queue_size_(max_queue_size) {
+        InitQueue(IsLockFreeQueue<Queue>());
     }
 
     ~ThreadPool() {
@@ -56,8 +75,11 @@ public:
     }
 
     void stop() {
+        if (timer_wheel_) {
+            timer_wheel_->stop();
+        }
         {
-            LockGuard<Mutex> guard(mutex_);
+            LockGuard<Lock> guard(mutex_);
             running_ = false;
             not_empty_.NotifyAll();
             not_full_.NotifyAll();
@@ -67,29 +89,86 @@ public:
         }
     }
 
-    void RunTask(const Task& task) {
+    void RunTask(Task&& task) {
         if (threads_.empty()) {
             task();
         } else {
-            LockGuard<Mutex> guard(mutex_);
-            while (IsFull() && running_) {
-                not_full_.Wait();
-            }
-            if (!running_) {
-                return;
+            Push(std::move(task), IsLockFreeQueue<Queue>());
+        }
+    }
+
+    // lanes of a PriorityTaskQueue, other queues ignore the priority
+    void RunTask(Task&& task, TaskPriority priority) {
+        Emplace(PriorityTask(std::move(task), priority));
+    }
+
+    // dropped instead of run if it did not start before deadline, a
+    // PriorityTaskQueue runs such tasks earliest deadline first
+    void RunTask(Task&& task, std::chrono::steady_clock::time_point deadline) {
+        Emplace(DeadlineTask(std::move(task), deadline, &dropped_tasks_));
+    }
+
+    // tasks dropped because their deadline passed
+    size_t NumDroppedTasks() const {
+        return dropped_tasks_.load();
+    }
+
+    // constructs the task in place in the queue when it is mutex guarded
+    template <typename F>
+    void Emplace(F&& f) {
+        if (threads_.empty()) {
+            f();
+        } else {
+            Push(std::forward<F>(f), IsLockFreeQueue<Queue>());
+        }
+    }
+
+    // enqueues [begin, end) under one lock acquisition and wakes up at most
+    // as many idle threads as tasks were added, *begin must be convertible
+    // to Task, pass move iterators for a range of Tasks.
+    template <typename Iterator>
+    void RunTasks(Iterator begin, Iterator end) {
+        if (threads_.empty()) {
+            for (; begin != end; ++begin) {
+                Task task(*begin);
+                task();
             }
-            queue_.push_back(task);
-            not_empty_.Notify();
+        } else {
+            PushRange(begin, end, IsLockFreeQueue<Queue>());
         }
     }
 
-    void SetThreadInitCallback(const Task& cb) {
-        thread_init_callback_ = cb;
+    // runs task on the pool after microseconds, the timer wheel thread
+    // is started on first use.
+    TimerId RunAfter(int64_t microseconds, Task&& task) {
+        return GetTimerWheel().RunAfter(microseconds, std::move(task), &ThreadPool::DispatchTimer, this);
+    }
+
+    // runs task on the pool every microseconds, a period is skipped while
+    // the previous run has not finished yet.
+    TimerId RunEvery(int64_t microseconds, Task&& task) {
+        return GetTimerWheel().RunEvery(microseconds, std::move(task), &ThreadPool::DispatchTimer, this);
+    }
+
+    bool CancelTimer(TimerId id) {
+        return GetTimerWheel().Cancel(id);
+    }
+
+    // co_await pool.Schedule() continues the coroutine on a pool thread
+    ScheduleAwaiter<ThreadPool> Schedule() {
+        return ScheduleAwaiter<ThreadPool>(*this);
+    }
+
+    void SetThreadInitCallback(Task&& cb) {
+        thread_init_callback_ = std::move(cb);
+    }
+
+    size_t NumThreads() const {
+        return num_threads_;
     }
 
     size_t QueueSize() const {
-        LockGuard<Mutex> guard(mutex_);
-        return queue_.size();
+        return Size(IsLockFreeQueue<Queue>());
     }
 
 private:
@@ -99,7 +178,7 @@ private:
                 thread_init_callback_();
             }
             while (running_) {
-                Task task = Take();
+                Task task = Take(IsLockFreeQueue<Queue>());
                 if (task) {
                     task();
                 }
@@ -113,14 +192,157 @@ private:
         }
     }
 
-    Task Take() {
-        LockGuard<Mutex> guard(mutex_);
+    // due timer tasks are queued as they are, without a wrapper. the timer
+    // thread must not wait for room in a bounded queue, the timer wheel
+    // retries what did not fit.
+    static bool DispatchTimer(void* pool, TimerWheel::Callback& cb) {
+        ThreadPool* self = static_cast<ThreadPool*>(pool);
+        if (self->threads_.empty()) {
+            cb();
+            return true;
+        }
+        return self->TryPush(cb, IsLockFreeQueue<Queue>());
+    }
+
+    TimerWheel& GetTimerWheel() {
+        std::call_once(timer_wheel_once_, [this]() {
+            timer_wheel_.reset(new TimerWheel());
+            timer_wheel_->start();
+        });
+        return *timer_wheel_;
+    }
+
+    void InitQueue(std::false_type) {
+    }
+
+    // a ring buffer cannot grow, an unbounded pool gets the default capacity
+    void InitQueue(std::true_type) {
+        queue_.Reserve(max_queue_size_ > 0 ? max_queue_size_ : Queue::kDefaultCapacity);
+    }
+
+    template <typename F>
+    void Push(F&& f, std::false_type) {
+        LockGuard<Lock> guard(mutex_);
+        while (IsFull() && running_) {
+            not_full_.Wait();
+        }
+        if (!running_) {
+            return;
+        }
+        queue_.emplace_back(std::forward<F>(f));
+        not_empty_.Notify();
+    }
+
+    // the waiter counters are raised before the queue is rechecked under
+    // mutex_, and the other side reads them after touching the queue, so
+    // either the sleeper sees the change or the other side wakes it up.
+    template <typename F>
+    void Push(F&& f, std::true_type) {
+        if (TryEnqueue(std::forward<F>(f))) {
+            WakeUpIdle(1);
+        }
+    }
+
+    // never waits, returns false and leaves task alone if the queue is full
+    bool TryPush(Task& task, std::false_type) {
+        LockGuard<Lock> guard(mutex_);
+        if (!running_) {
+            return true;
+        }
+        if (IsFull()) {
+            return false;
+        }
+        queue_.emplace_back(std::move(task));
+        not_empty_.Notify();
+        return true;
+    }
+
+    bool TryPush(Task& task, std::true_type) {
+        if (!running_) {
+            return true;
+        }
+        if (!queue_.TryPush(std::move(task))) {
+            return false;
+        }
+        WakeUpIdle(1);
+        return true;
+    }
+
+    template <typename Iterator>
+    void PushRange(Iterator begin, Iterator end, std::false_type) {
+        LockGuard<Lock> guard(mutex_);
+        size_t num = 0;
+        for (; begin != end; ++begin) {
+            while (IsFull() && running_) {
+                NotifyIdle(num);
+                num = 0;
+                not_full_.Wait();
+            }
+            if (!running_) {
+                return;
+            }
+            queue_.emplace_back(*begin);
+            ++num;
+        }
+        NotifyIdle(num);
+    }
+
+    template <typename Iterator>
+    void PushRange(Iterator begin, Iterator end, std::true_type) {
+        size_t num = 0;
+        for (; begin != end && TryEnqueue(*begin); ++begin) {
+            ++num;
+        }
+        WakeUpIdle(num);
+    }
+
+    // returns false if the pool stopped before the task got in
+    template <typename F>
+    bool TryEnqueue(F&& f) {
+        Task task(std::forward<F>(f));
+        while (running_ && !queue_.TryPush(std::move(task))) {
+            LockGuard<Lock> guard(mutex_);
+            ++waiting_producers_;
+            // tasks pushed by the current batch may not have woken anyone yet
+            if (queue_.Full() && idle_threads_.load() > 0) {
+                not_empty_.NotifyAll();
+            }
+            while (queue_.Full() && running_) {
+                not_full_.Wait();
+            }
+            --waiting_producers_;
+        }
+        return running_;
+    }
+
+    void WakeUpIdle(size_t num) {
+        if (num > 0 && idle_threads_.load() > 0) {
+            LockGuard<Lock> guard(mutex_);
+            NotifyIdle(num);
+        }
+    }
+
+    // mutex_ must be held
+    void NotifyIdle(size_t num) {
+        if (num >= idle_threads_.load()) {
+            not_empty_.NotifyAll();
+        } else {
+            for (size_t i = 0; i < num; ++i) {
+                not_empty_.Notify();
+            }
+        }
+    }
+
+    Task Take(std::false_type) {
+        LockGuard<Lock> guard(mutex_);
+        ++idle_threads_;
         while (queue_.empty() && running_) {
             not_empty_.Wait();
         }
+        --idle_threads_;
         Task task;
         if (!queue_.empty()) {
-            task = queue_.front();
+            task = std::move(queue_.front());
             queue_.pop_front();
             if (max_queue_size_ > 0) {
                 not_full_.Notify();
@@ -129,19 +351,50 @@ private:
         return task;
     }
 
+    Task Take(std::true_type) {
+        Task task;
+        while (running_ && !queue_.TryPop(task)) {
+            LockGuard<Lock> guard(mutex_);
+            ++idle_threads_;
+            while (queue_.Empty() && running_) {
+                not_empty_.Wait();
+            }
+            --idle_threads_;
+        }
+        if (waiting_producers_.load() > 0) {
+            LockGuard<Lock> guard(mutex_);
+            not_full_.Notify();
+        }
+        return task;
+    }
+
+    size_t Size(std::false_type) const {
+        LockGuard<Lock> guard(mutex_);
+        return queue_.size();
+    }
+
+    size_t Size(std::true_type) const {
+        return queue_.Size();
+    }
+
     bool IsFull() const {
         return max_queue_size_ > 0 && queue_.size() >= max_queue_size_; 
     }
 
-    bool running_;
-    mutable Mutex mutex_;
-    Condition not_empty_;
-    Condition not_full_;
+    std::atomic<bool> running_;
+    mutable Lock mutex_;
+    typename ConditionOf<Lock>::type not_empty_;
+    typename ConditionOf<Lock>::type not_full_;
+    std::atomic<size_t> idle_threads_;
+    std::atomic<size_t> waiting_producers_;
+    std::atomic<size_t> dropped_tasks_;
     Task thread_init_callback_;
     size_t num_threads_;
     std::vector<std::shared_ptr<std::thread>> threads_;
     size_t max_queue_size_;
     Queue queue_;
+    std::once_flag timer_wheel_once_;
+    std::unique_ptr<TimerWheel> timer_wheel_;
 };
 
 } // namespace arcane
@@ -10,6 +10,15 @@ int64_t GetTid();
 
 std::string GetTidString();
 
+// hint to the cpu that the caller is busy waiting
+inline void CpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
 } // namespace arcane
 
 #endif
@@ -0,0 +1,374 @@
+
+#include <arcane/timer_wheel.h>
+
+#include <stdlib.h>
+#include <algorithm>
+#include <exception>
+
+#include <arcane/lock_guard.h>
+#include <arcane/log.h>
+
+namespace arcane {
+
+namespace detail {
+
+constexpr const int64_t kMaxTimerTicks = (static_cast<int64_t>(1) << 32) - 1;
+
+} // namespace detail
+
+TimerWheel::TimerWheel(int64_t tick_microseconds)
+    : tick_microseconds_(tick_microseconds),
+      base_(std::chrono::steady_clock::now()),
+      running_(false),
+      mutex_(),
+      cond_(mutex_),
+      current_tick_(0),
+      wake_tick_(INT64_MAX),
+      size_(0),
+      free_list_(kNil) {
+    std::fill(std::begin(slots_), std::end(slots_), kNil);
+}
+
+TimerWheel::~TimerWheel() {
+    if (running_) {
+        stop();
+    }
+}
+
+void TimerWheel::start() {
+    running_ = true;
+    thread_.reset(new std::thread(&TimerWheel::RunInThread, this));
+}
+
+void TimerWheel::stop() {
+    {
+        LockGuard<Mutex> guard(mutex_);
+        running_ = false;
+        cond_.Notify();
+    }
+    if (thread_ && thread_->joinable()) {
+        thread_->join();
+    }
+}
+
+TimerId TimerWheel::RunAfter(int64_t microseconds, Callback&& cb,
+                             Dispatch dispatch, void* executor) {
+    return Add(microseconds, 0, std::move(cb), dispatch, executor);
+}
+
+TimerId TimerWheel::RunEvery(int64_t microseconds, Callback&& cb,
+                             Dispatch dispatch, void* executor) {
+    int64_t interval = std::max((microseconds + tick_microseconds_ - 1) / tick_microseconds_,
+                                static_cast<int64_t>(1));
+    return Add(microseconds, interval, std::move(cb), dispatch, executor);
+}
+
+bool TimerWheel::Cancel(TimerId id) {
+    uint32_t index = static_cast<uint32_t>(id);
+    uint32_t generation = static_cast<uint32_t>(id >> 32);
+    LockGuard<Mutex> guard(mutex_);
+    if (index >= nodes_.size()) {
+        return false;
+    }
+    Node& node = nodes_[index];
+    if (node.generation != generation || node.cancelled) {
+        return false;
+    }
+    if (node.running && node.interval == 0) {
+        // a one shot timer being dispatched
+        return false;
+    }
+    --size_;
+    if (node.running) {
+        node.cancelled = true;
+    } else {
+        Unlink(index);
+        if (node.in_flight) {
+            node.cancelled = true;
+        } else {
+            FreeNode(index);
+        }
+    }
+    return true;
+}
+
+size_t TimerWheel::Size() const {
+    LockGuard<Mutex> guard(mutex_);
+    return size_;
+}
+
+TimerId TimerWheel::Add(int64_t microseconds, int64_t interval, Callback&& cb,
+                        Dispatch dispatch, void* executor) {
+    int64_t elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - base_).count();
+    // rounded up, a timer never fires early
+    int64_t expire = (elapsed + std::max(microseconds, static_cast<int64_t>(0)) +
+                      tick_microseconds_ - 1) / tick_microseconds_;
+
+    LockGuard<Mutex> guard(mutex_);
+    if (size_ == 0) {
+        // nothing to catch up with for an empty wheel
+        current_tick_ = std::max(current_tick_, NowTick());
+    }
+    uint32_t index = AllocNode();
+    Node& node = nodes_[index];
+    node.expire = expire;
+    node.interval = interval;
+    node.dispatch = dispatch;
+    node.executor = executor;
+    node.cb = std::move(cb);
+    Link(index);
+    ++size_;
+    if (expire < wake_tick_) {
+        cond_.Notify();
+    }
+    return (static_cast<TimerId>(node.generation) << 32) | index;
+}
+
+uint32_t TimerWheel::AllocNode() {
+    uint32_t index = free_list_;
+    if (index != kNil) {
+        free_list_ = nodes_[index].next;
+    } else {
+        index = static_cast<uint32_t>(nodes_.size());
+        nodes_.emplace_back();
+    }
+    return index;
+}
+
+void TimerWheel::FreeNode(uint32_t index) {
+    Node& node = nodes_[index];
+    ++node.generation;
+    node.running = false;
+    node.in_flight = false;
+    node.cancelled = false;
+    node.dispatch = nullptr;
+    node.executor = nullptr;
+    node.cb = nullptr;
+    node.prev = kNil;
+    node.next = free_list_;
+    free_list_ = index;
+}
+
+void TimerWheel::Link(uint32_t index) {
+    Node& node = nodes_[index];
+    int64_t delta = node.expire - current_tick_;
+    uint32_t slot = 0;
+    if (delta < (1 << kRootBits)) {
+        // overdue timers run with the tick being processed
+        slot = static_cast<uint32_t>(std::max(node.expire, current_tick_) & ((1 << kRootBits) - 1));
+    } else {
+        // timers beyond the last level wait there and are placed again
+        int64_t expire = std::min(node.expire, current_tick_ + detail::kMaxTimerTicks);
+        delta = expire - current_tick_;
+        int level = 1;
+        while (level < kLevels - 1 && delta >= (static_cast<int64_t>(1) << (kRootBits + level * kLevelBits))) {
+            ++level;
+        }
+        int shift = kRootBits + (level - 1) * kLevelBits;
+        slot = (1 << kRootBits) + (level - 1) * (1 << kLevelBits) +
+               static_cast<uint32_t>((expire >> shift) & ((1 << kLevelBits) - 1));
+    }
+    node.slot = slot;
+    node.prev = kNil;
+    node.next = slots_[slot];
+    if (node.next != kNil) {
+        nodes_[node.next].prev = index;
+    }
+    slots_[slot] = index;
+}
+
+void TimerWheel::Unlink(uint32_t index) {
+    Node& node = nodes_[index];
+    if (node.prev != kNil) {
+        nodes_[node.prev].next = node.next;
+    } else {
+        slots_[node.slot] = node.next;
+    }
+    if (node.next != kNil) {
+        nodes_[node.next].prev = node.prev;
+    }
+    node.prev = kNil;
+    node.next = kNil;
+    node.slot = kNil;
+}
+
+// moves the timers of an upper level slot to where they belong now
+void TimerWheel::Cascade(uint32_t slot) {
+    uint32_t index = slots_[slot];
+    slots_[slot] = kNil;
+    while (index != kNil) {
+        uint32_t next = nodes_[index].next;
+        Link(index);
+        index = next;
+    }
+}
+
+void TimerWheel::RunInThread() {
+    try {
+        LockGuard<Mutex> guard(mutex_);
+        while (running_) {
+            int64_t now = NowTick();
+            while (current_tick_ <= now && running_) {
+                ProcessTick();
+            }
+            if (!running_) {
+                break;
+            }
+            wake_tick_ = NextWakeTick();
+            if (wake_tick_ == INT64_MAX) {
+                cond_.Wait();
+            } else {
+                int64_t elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+                        std::chrono::steady_clock::now() - base_).count();
+                int64_t microseconds = wake_tick_ * tick_microseconds_ - elapsed;
+                if (microseconds > 0) {
+                    cond_.TimedWaitMicroseconds(microseconds);
+                }
+            }
+            wake_tick_ = INT64_MAX;
+        }
+    } catch (const std::exception& e) {
+        LOG_ERROR << "exception caught in TimerWheel, reason: " << e.what();
+        abort();
+    } catch (...) {
+        LOG_ERROR << "unknown exception caught in TimerWheel";
+        throw;
+    }
+}
+
+// mutex_ is held on entry and exit, released while callbacks run
+void TimerWheel::ProcessTick() {
+    uint32_t root = static_cast<uint32_t>(current_tick_ & ((1 << kRootBits) - 1));
+    if (root == 0) {
+        for (int level = 1; level < kLevels; ++level) {
+            int shift = kRootBits + (level - 1) * kLevelBits;
+            uint32_t index = static_cast<uint32_t>((current_tick_ >> shift) & ((1 << kLevelBits) - 1));
+            Cascade((1 << kRootBits) + (level - 1) * (1 << kLevelBits) + index);
+            if (index != 0) {
+                break;
+            }
+        }
+    }
+    ++current_tick_;
+
+    expired_.clear();
+    for (uint32_t index = slots_[root]; index != kNil; index = nodes_[index].next) {
+        expired_.push_back(index);
+        nodes_[index].running = true;
+        nodes_[index].slot = kNil;
+    }
+    slots_[root] = kNil;
+
+    for (uint32_t index : expired_) {
+        Node& node = nodes_[index];
+        if (node.cancelled) {
+            if (node.in_flight) {
+                node.running = false;
+            } else {
+                FreeNode(index);
+            }
+        } else if (node.interval == 0 && node.dispatch != nullptr) {
+            // kept while being dispatched, so it can be retried if refused
+            Callback cb = std::move(node.cb);
+            Dispatch dispatch = node.dispatch;
+            void* executor = node.executor;
+            mutex_.Unlock();
+            bool dispatched = dispatch(executor, cb);
+            mutex_.Lock();
+            if (dispatched) {
+                FreeNode(index);
+                --size_;
+            } else {
+                node.cb = std::move(cb);
+                node.running = false;
+                node.expire = current_tick_;
+                Link(index);
+            }
+        } else if (node.interval == 0) {
+            Callback cb = std::move(node.cb);
+            FreeNode(index);
+            --size_;
+            mutex_.Unlock();
+            cb();
+            mutex_.Lock();
+        } else if (node.dispatch != nullptr) {
+            // stays in the wheel, the dispatched run borrows the callback
+            bool skip = node.in_flight;
+            node.running = false;
+            node.in_flight = true;
+            node.expire += node.interval;
+            Link(index);
+            if (!skip) {
+                Dispatch dispatch = node.dispatch;
+                void* executor = node.executor;
+                Callback run([this, index]() {
+                    RunDispatched(index);
+                });
+                mutex_.Unlock();
+                bool dispatched = dispatch(executor, run);
+                mutex_.Lock();
+                if (!dispatched) {
+                    node.in_flight = false;
+                    if (node.cancelled) {
+                        FreeNode(index);
+                    }
+                }
+            }
+        } else {
+            mutex_.Unlock();
+            node.cb();
+            mutex_.Lock();
+            if (node.cancelled) {
+                FreeNode(index);
+            } else {
+                node.running = false;
+                node.expire += node.interval;
+                Link(index);
+            }
+        }
+    }
+}
+
+// a periodic run on the executor, the node is not freed while in flight
+void TimerWheel::RunDispatched(uint32_t index) {
+    Callback cb;
+    {
+        LockGuard<Mutex> guard(mutex_);
+        if (!nodes_[index].cancelled) {
+            cb = std::move(nodes_[index].cb);
+        }
+    }
+    if (cb) {
+        cb();
+    }
+    LockGuard<Mutex> guard(mutex_);
+    Node& node = nodes_[index];
+    node.in_flight = false;
+    if (!node.cancelled) {
+        node.cb = std::move(cb);
+    } else if (!node.running) {
+        FreeNode(index);
+    }
+}
+
+int64_t TimerWheel::NowTick() const {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - base_).count() / tick_microseconds_;
+}
+
+// the next tick with due timers, or the next cascade, INT64_MAX if empty
+int64_t TimerWheel::NextWakeTick() const {
+    if (size_ == 0) {
+        return INT64_MAX;
+    }
+    for (int64_t tick = current_tick_; tick < current_tick_ + (1 << kRootBits); ++tick) {
+        uint32_t root = static_cast<uint32_t>(tick & ((1 << kRootBits) - 1));
+        if (slots_[root] != kNil || root == 0) {
+            return tick;
+        }
+    }
+    return current_tick_ + (1 << kRootBits);
+}
+
+} // namespace arcane
@@ -0,0 +1,141 @@
+#ifndef ARCANE_TIMER_WHEEL_H
+#define ARCANE_TIMER_WHEEL_H
+
+#include <stdint.h>
+#include <deque>
+#include <vector>
+#include <thread>
+#include <memory>
+#include <chrono>
+#include <atomic>
+
+#include <arcane/mutex.h>
+#include <arcane/condition.h>
+#include <arcane/unique_task.h>
+
+namespace arcane {
+
+// 0 is never a valid id
+using TimerId = uint64_t;
+
+// Hierarchical timing wheel driven by one thread. Level 0 has 256 slots of
+// one tick each, every further level has 64 slots covering a whole turn of
+// the level below, timers are cascaded down as their turn comes closer.
+// Insert and cancel are O(1), timer nodes are recycled through a free list
+// and callbacks are stored inline, so millions of pending timers cost no
+// allocations once the node pool has grown.
+//
+// Callbacks run in the timer thread and must be short, hand longer work
+// over to a ThreadPool. A timer added with a dispatch function hands its
+// callback to dispatch instead, which passes it on to an executor without
+// wrapping it, so such timers cost no allocations either. dispatch must
+// not block the timer thread, an executor that is full refuses the
+// callback instead.
+class TimerWheel {
+public:
+    using Callback = UniqueTask;
+    // called in the timer thread with the executor the timer was added with,
+    // returns false and leaves cb alone if the executor cannot take it now.
+    // a refused one shot timer is retried the next tick, a refused periodic
+    // run skips its period.
+    using Dispatch = bool (*)(void* executor, Callback& cb);
+
+    explicit TimerWheel(int64_t tick_microseconds = 1000);
+    ~TimerWheel();
+
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    void start();
+    void stop();
+
+    // runs cb once after microseconds
+    TimerId RunAfter(int64_t microseconds, Callback&& cb,
+                     Dispatch dispatch = nullptr, void* executor = nullptr);
+
+    // runs cb every microseconds, the first time after one interval. With
+    // a dispatch function a period is skipped while the previous
+    // dispatched run has not finished yet.
+    TimerId RunEvery(int64_t microseconds, Callback&& cb,
+                     Dispatch dispatch = nullptr, void* executor = nullptr);
+
+    // returns false if the timer already fired (one shot), is being handed
+    // to its executor or does not exist, a periodic timer cancelled while running is not run again.
+    bool Cancel(TimerId id);
+
+    // pending timers
+    size_t Size() const;
+
+private:
+    static constexpr const int kLevels = 5;
+    static constexpr const int kRootBits = 8;
+    static constexpr const int kLevelBits = 6;
+    static constexpr const uint32_t kNil = UINT32_MAX;
+
+    struct Node {
+        Node()
+            : expire(0),
+              interval(0),
+              prev(kNil),
+              next(kNil),
+              generation(1),
+              slot(kNil),
+              running(false),
+              in_flight(false),
+              cancelled(false),
+              dispatch(nullptr),
+              executor(nullptr) {
+        }
+
+        int64_t expire;
+        int64_t interval;
+        uint32_t prev;
+        uint32_t next;
+        uint32_t generation;
+        // index into slots_, kNil while not linked
+        uint32_t slot;
+        // taken out of the wheel to run, Cancel only flags it then
+        bool running;
+        // a periodic run handed to dispatch has not finished, the node is
+        // freed by whichever of it and the timer thread is done last
+        bool in_flight;
+        bool cancelled;
+        Dispatch dispatch;
+        void* executor;
+        Callback cb;
+    };
+
+    TimerId Add(int64_t microseconds, int64_t interval, Callback&& cb,
+                Dispatch dispatch, void* executor);
+    void RunDispatched(uint32_t index);
+    uint32_t AllocNode();
+    void FreeNode(uint32_t index);
+    void Link(uint32_t index);
+    void Unlink(uint32_t index);
+    void Cascade(uint32_t slot);
+    void RunInThread();
+    void ProcessTick();
+    int64_t NowTick() const;
+    int64_t NextWakeTick() const;
+
+    const int64_t tick_microseconds_;
+    const std::chrono::steady_clock::time_point base_;
+    std::atomic<bool> running_;
+    mutable Mutex mutex_;
+    Condition cond_;
+    // next tick to be processed
+    int64_t current_tick_;
+    int64_t wake_tick_;
+    size_t size_;
+    std::deque<Node> nodes_;
+    uint32_t free_list_;
+    // nodes due in the tick being processed, kept to reuse its capacity
+    std::vector<uint32_t> expired_;
+    // heads of the slot lists, level 0 first
+    uint32_t slots_[(1 << kRootBits) + (kLevels - 1) * (1 << kLevelBits)];
+    std::unique_ptr<std::thread> thread_;
+};
+
+} // namespace arcane
+
+#endif
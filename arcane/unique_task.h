@@ -0,0 +1,178 @@
+#ifndef ARCANE_UNIQUE_TASK_H
+#define ARCANE_UNIQUE_TASK_H
+
+#include <stddef.h>
+#include <new>
+#include <functional>
+#include <utility>
+#include <type_traits>
+
+namespace arcane {
+
+// Move-only replacement of std::function<void ()>. Callables up to
+// kInlineSize bytes which are nothrow move constructible live inside the
+// task itself, only bigger ones are allocated on the heap. The buffer and
+// the ops pointer fill one 64 byte cache line.
+class UniqueTask {
+public:
+    static constexpr const size_t kInlineSize = 56;
+    static constexpr const size_t kInlineAlign = alignof(void*);
+
+    UniqueTask() noexcept
+        : ops_(nullptr) {
+    }
+
+    UniqueTask(std::nullptr_t) noexcept
+        : ops_(nullptr) {
+    }
+
+    template <typename F,
+              typename = typename std::enable_if<
+                  !std::is_same<typename std::decay<F>::type, UniqueTask>::value>::type>
+    UniqueTask(F&& f)
+        : ops_(nullptr) {
+        using Functor = typename std::decay<F>::type;
+        if (!IsEmpty(f)) {
+            Init<Functor>(std::forward<F>(f), IsInline<Functor>());
+        }
+    }
+
+    UniqueTask(UniqueTask&& other) noexcept
+        : ops_(other.ops_) {
+        if (ops_ != nullptr) {
+            ops_->move(&other.storage_, &storage_);
+            other.ops_ = nullptr;
+        }
+    }
+
+    UniqueTask& operator=(UniqueTask&& other) noexcept {
+        if (this != &other) {
+            Reset();
+            if (other.ops_ != nullptr) {
+                other.ops_->move(&other.storage_, &storage_);
+                ops_ = other.ops_;
+                other.ops_ = nullptr;
+            }
+        }
+        return *this;
+    }
+
+    UniqueTask& operator=(std::nullptr_t) noexcept {
+        Reset();
+        return *this;
+    }
+
+    ~UniqueTask() {
+        Reset();
+    }
+
+    UniqueTask(const UniqueTask&) = delete;
+    UniqueTask& operator=(const UniqueTask&) = delete;
+
+    void operator()() {
+        ops_->invoke(&storage_);
+    }
+
+    explicit operator bool() const noexcept {
+        return ops_ != nullptr;
+    }
+
+private:
+    struct Ops {
+        void (*invoke)(void* storage);
+        // move constructs into to and destroys from
+        void (*move)(void* from, void* to);
+        void (*destroy)(void* storage);
+    };
+
+    template <typename F>
+    struct InlineOps {
+        static void Invoke(void* storage) {
+            (*static_cast<F*>(storage))();
+        }
+
+        static void Move(void* from, void* to) {
+            F* f = static_cast<F*>(from);
+            new (to) F(std::move(*f));
+            f->~F();
+        }
+
+        static void Destroy(void* storage) {
+            static_cast<F*>(storage)->~F();
+        }
+
+        static constexpr const Ops kOps = {&Invoke, &Move, &Destroy};
+    };
+
+    template <typename F>
+    struct HeapOps {
+        static void Invoke(void* storage) {
+            (**static_cast<F**>(storage))();
+        }
+
+        static void Move(void* from, void* to) {
+            *static_cast<F**>(to) = *static_cast<F**>(from);
+        }
+
+        static void Destroy(void* storage) {
+            delete *static_cast<F**>(storage);
+        }
+
+        static constexpr const Ops kOps = {&Invoke, &Move, &Destroy};
+    };
+
+    template <typename F>
+    using IsInline = std::integral_constant<bool,
+          sizeof(F) <= kInlineSize &&
+          alignof(F) <= kInlineAlign &&
+          std::is_nothrow_move_constructible<F>::value>;
+
+    template <typename F, typename Arg>
+    void Init(Arg&& f, std::true_type) {
+        new (&storage_) F(std::forward<Arg>(f));
+        ops_ = &InlineOps<F>::kOps;
+    }
+
+    template <typename F, typename Arg>
+    void Init(Arg&& f, std::false_type) {
+        *reinterpret_cast<F**>(&storage_) = new F(std::forward<Arg>(f));
+        ops_ = &HeapOps<F>::kOps;
+    }
+
+    template <typename F>
+    static bool IsEmpty(const F&) {
+        return false;
+    }
+
+    template <typename R, typename... Args>
+    static bool IsEmpty(const std::function<R (Args...)>& f) {
+        return !f;
+    }
+
+    template <typename R, typename... Args>
+    static bool IsEmpty(R (*f)(Args...)) {
+        return f == nullptr;
+    }
+
+    void Reset() {
+        if (ops_ != nullptr) {
+            ops_->destroy(&storage_);
+            ops_ = nullptr;
+        }
+    }
+
+    alignas(kInlineAlign) unsigned char storage_[kInlineSize];
+    const Ops* ops_;
+};
+
+static_assert(sizeof(UniqueTask) == 64, "UniqueTask should fill one cache line");
+
+template <typename F>
+constexpr const UniqueTask::Ops UniqueTask::InlineOps<F>::kOps;
+
+template <typename F>
+constexpr const UniqueTask::Ops UniqueTask::HeapOps<F>::kOps;
+
+} // namespace arcane
+
+#endif
@@ -0,0 +1,192 @@
+#ifndef ARCANE_W_TINY_LFU_H
+#define ARCANE_W_TINY_LFU_H
+
+#include <stdint.h>
+#include <algorithm>
+#include <vector>
+
+#include <arcane/lru.h>
+
+namespace arcane {
+
+namespace detail {
+
+// Count-min sketch estimating how often a key hash was seen lately: four
+// rows of saturating counters, the estimate is the smallest of the key's
+// four counters. After ten increments per counter of a row all counters
+// are halved, so old popularity fades.
+class FrequencySketch {
+public:
+    static constexpr const uint8_t kMaxCount = 15;
+
+    explicit FrequencySketch(size_t max_size)
+        : mask_(Width(max_size) - 1),
+          sample_size_(10 * (mask_ + 1)),
+          additions_(0),
+          counters_(kRows * (mask_ + 1), 0) {
+    }
+
+    void Increment(uint64_t hash) {
+        bool added = false;
+        for (size_t row = 0; row < kRows; ++row) {
+            uint8_t& counter = counters_[Index(hash, row)];
+            if (counter < kMaxCount) {
+                ++counter;
+                added = true;
+            }
+        }
+        if (added && ++additions_ >= sample_size_) {
+            Age();
+        }
+    }
+
+    uint8_t Estimate(uint64_t hash) const {
+        uint8_t count = kMaxCount;
+        for (size_t row = 0; row < kRows; ++row) {
+            count = std::min(count, counters_[Index(hash, row)]);
+        }
+        return count;
+    }
+
+private:
+    static constexpr const size_t kRows = 4;
+
+    static size_t Width(size_t max_size) {
+        size_t width = 16;
+        while (width < max_size) {
+            width *= 2;
+        }
+        return width;
+    }
+
+    // an independent looking column per row from one hash
+    size_t Index(uint64_t hash, size_t row) const {
+        uint64_t x = (hash + row * 0x9e3779b97f4a7c15ULL) * 0xbf58476d1ce4e5b9ULL;
+        x ^= x >> 31;
+        return row * (mask_ + 1) + (x & mask_);
+    }
+
+    void Age() {
+        for (auto& counter : counters_) {
+            counter /= 2;
+        }
+        additions_ /= 2;
+    }
+
+    size_t mask_;
+    size_t sample_size_;
+    size_t additions_;
+    std::vector<uint8_t> counters_;
+};
+
+} // namespace detail
+
+// W-TinyLFU admission: new entries land in a window LRU of 1% of the size.
+// An entry pushed out of the window only enters the main cache, a
+// segmented LRU, if it was seen more often lately than the main cache's
+// next victim, going by a frequency sketch. A scan of keys used once passes
+// through the window without flushing the main cache. Main cache entries
+// hit again move from its probation segment to the protected one, which
+// holds up to 80% of it.
+struct WTinyLfuPolicy {
+    template <typename Key, typename T, typename Hash>
+    class Cache {
+    public:
+        explicit Cache(size_t max_size)
+            : window_size_(std::min(max_size, std::max<size_t>(1, max_size / 100))),
+              main_size_(max_size > window_size_ ? max_size - window_size_ : 0),
+              protected_size_(main_size_ * 8 / 10),
+              sketch_(max_size),
+              hash_() {
+        }
+
+        void Put(const Key& key, const T& data) {
+            auto node = segments_.Find(key);
+            if (node != nullptr) {
+                node->it->second = data;
+                Access(node);
+                return;
+            }
+            sketch_.Increment(hash_(key));
+            segments_.PushBack(kWindow, key, data);
+            if (segments_.Size(kWindow) > window_size_) {
+                Admit();
+            }
+        }
+
+        T* Find(const Key& key) {
+            auto node = segments_.Find(key);
+            if (node == nullptr) {
+                // misses count too, a key missed often is worth admitting
+                sketch_.Increment(hash_(key));
+                return nullptr;
+            }
+            Access(node);
+            return &node->it->second;
+        }
+
+        void Erase(const Key& key) {
+            auto node = segments_.Find(key);
+            if (node != nullptr) {
+                segments_.Erase(node);
+            }
+        }
+
+        size_t Size() const {
+            return segments_.Size(kWindow) + segments_.Size(kProbation) + segments_.Size(kProtected);
+        }
+
+    private:
+        enum Segment {
+            kWindow = 0,
+            kProbation = 1,
+            kProtected = 2,
+        };
+
+        using Segments = detail::LruSegments<Key, T, Hash, 3>;
+
+        void Access(typename Segments::Node* node) {
+            sketch_.Increment(hash_(node->it->first));
+            if (node->segment != kProbation) {
+                segments_.MoveToBack(node, node->segment);
+                return;
+            }
+            segments_.MoveToBack(node, kProtected);
+            if (segments_.Size(kProtected) > protected_size_) {
+                segments_.MoveToBack(segments_.Front(kProtected), kProbation);
+            }
+        }
+
+        // the least recent window entry competes with the main cache's
+        void Admit() {
+            auto candidate = segments_.Front(kWindow);
+            if (segments_.Size(kProbation) + segments_.Size(kProtected) < main_size_) {
+                segments_.MoveToBack(candidate, kProbation);
+                return;
+            }
+            size_t victim_segment = segments_.Size(kProbation) > 0 ? kProbation : kProtected;
+            if (main_size_ == 0 || segments_.Size(victim_segment) == 0) {
+                segments_.Erase(candidate);
+                return;
+            }
+            auto victim = segments_.Front(victim_segment);
+            if (sketch_.Estimate(hash_(candidate->it->first)) > sketch_.Estimate(hash_(victim->it->first))) {
+                segments_.Erase(victim);
+                segments_.MoveToBack(candidate, kProbation);
+            } else {
+                segments_.Erase(candidate);
+            }
+        }
+
+        size_t window_size_;
+        size_t main_size_;
+        size_t protected_size_;
+        detail::FrequencySketch sketch_;
+        Segments segments_;
+        Hash hash_;
+    };
+};
+
+} // namespace arcane
+
+#endif
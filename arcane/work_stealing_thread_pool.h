@@ -0,0 +1,287 @@
+#ifndef ARCANE_WORK_STEALING_THREAD_POOL_H
+#define ARCANE_WORK_STEALING_THREAD_POOL_H
+
+#include <stdlib.h>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <memory>
+#include <utility>
+#include <atomic>
+#include <exception>
+
+#include <arcane/thread_pool.h>
+#include <arcane/mutex.h>
+#include <arcane/condition.h>
+#include <arcane/lock_guard.h>
+#include <arcane/log.h>
+#include <arcane/schedule_awaiter.h>
+
+namespace arcane {
+
+// Every worker owns a deque: the owner pushes and pops at the back (LIFO),
+// idle workers steal from the front of the others (FIFO). Tasks submitted
+// from a worker only touch that worker's deque, tasks submitted from outside
+// are spread round robin over the workers. The pool-wide mutex is used for
+// parking idle workers only, submitters take it when somebody sleeps.
+class WorkStealingThreadPool {
+public:
+    using Task = ThreadPoolTask;
+
+    explicit WorkStealingThreadPool(size_t num_threads)
+        : running_(false),
+          mutex_(),
+          idle_(mutex_),
+          sleeping_(0),
+          next_worker_(0),
+          num_threads_(num_threads) {
+    }
+
+    ~WorkStealingThreadPool() {
+        if (running_) {
+            stop();
+        }
+    }
+
+    WorkStealingThreadPool(const WorkStealingThreadPool&) = delete;
+    WorkStealingThreadPool& operator=(const WorkStealingThreadPool&) = delete;
+
+    void start() {
+        running_ = true;
+        workers_.reserve(num_threads_);
+        for (size_t i = 0; i < num_threads_; ++i) {
+            workers_.emplace_back(new Worker(this, i));
+        }
+        threads_.reserve(num_threads_);
+        for (size_t i = 0; i < num_threads_; ++i) {
+            std::shared_ptr<std::thread> p(
+                    new std::thread(&WorkStealingThreadPool::RunInThread, this, workers_[i].get()));
+            threads_.push_back(p);
+        }
+        if (threads_.empty() && thread_init_callback_) {
+            thread_init_callback_();
+        }
+    }
+
+    void stop() {
+        {
+            LockGuard<Mutex> guard(mutex_);
+            running_ = false;
+            idle_.NotifyAll();
+        }
+        for (auto thread : threads_) {
+            thread->join();
+        }
+    }
+
+    void RunTask(Task&& task) {
+        Emplace(std::move(task));
+    }
+
+    template <typename F>
+    void Emplace(F&& f) {
+        if (threads_.empty()) {
+            f();
+            return;
+        }
+        if (!running_) {
+            return;
+        }
+        Worker* worker = TargetWorker();
+        {
+            LockGuard<Mutex> guard(worker->mutex);
+            worker->tasks.emplace_back(std::forward<F>(f));
+            worker->size = worker->tasks.size();
+        }
+        WakeUpIfSleeping(1);
+    }
+
+    // the whole range goes into one deque under one lock acquisition, at
+    // most as many sleeping workers as tasks are woken up to steal from it
+    template <typename Iterator>
+    void RunTasks(Iterator begin, Iterator end) {
+        if (threads_.empty()) {
+            for (; begin != end; ++begin) {
+                Task task(*begin);
+                task();
+            }
+            return;
+        }
+        if (!running_) {
+            return;
+        }
+        Worker* worker = TargetWorker();
+        size_t num = 0;
+        {
+            LockGuard<Mutex> guard(worker->mutex);
+            for (; begin != end; ++begin) {
+                worker->tasks.emplace_back(*begin);
+                ++num;
+            }
+            worker->size = worker->tasks.size();
+        }
+        WakeUpIfSleeping(num);
+    }
+
+    // co_await pool.Schedule() continues the coroutine on a pool thread
+    ScheduleAwaiter<WorkStealingThreadPool> Schedule() {
+        return ScheduleAwaiter<WorkStealingThreadPool>(*this);
+    }
+
+    void SetThreadInitCallback(Task&& cb) {
+        thread_init_callback_ = std::move(cb);
+    }
+
+    size_t NumThreads() const {
+        return num_threads_;
+    }
+
+    size_t QueueSize() const {
+        size_t size = 0;
+        for (auto& worker : workers_) {
+            size += worker->size.load(std::memory_order_relaxed);
+        }
+        return size;
+    }
+
+private:
+    static constexpr const size_t kCacheLineSize = 64;
+
+    struct Worker {
+        Worker(WorkStealingThreadPool* owner, size_t i)
+            : pool(owner),
+              index(i),
+              size(0) {
+        }
+
+        WorkStealingThreadPool* pool;
+        size_t index;
+        Mutex mutex;
+        std::deque<Task> tasks;
+        std::atomic<size_t> size;
+        // keeps neighbouring workers off this cache line
+        char padding[kCacheLineSize];
+    };
+
+    static Worker*& LocalWorker() {
+        static thread_local Worker* t_worker = nullptr;
+        return t_worker;
+    }
+
+    Worker* CurrentWorker() const {
+        Worker* worker = LocalWorker();
+        if (worker != nullptr && worker->pool == this) {
+            return worker;
+        }
+        return nullptr;
+    }
+
+    // own deque inside a worker, round robin from outside
+    Worker* TargetWorker() {
+        Worker* worker = CurrentWorker();
+        if (worker == nullptr) {
+            size_t index = next_worker_.fetch_add(1, std::memory_order_relaxed);
+            worker = workers_[index % workers_.size()].get();
+        }
+        return worker;
+    }
+
+    void RunInThread(Worker* self) {
+        try {
+            LocalWorker() = self;
+            if (thread_init_callback_) {
+                thread_init_callback_();
+            }
+            while (running_) {
+                Task task;
+                if (Take(self, task)) {
+                    task();
+                } else {
+                    Park();
+                }
+            }
+            LocalWorker() = nullptr;
+        } catch (const std::exception& e) {
+            LOG_ERROR << "exception caught in WorkStealingThreadPool, reason: " << e.what();
+            abort();
+        } catch (...) {
+            LOG_ERROR << "unknown exception caught in WorkStealingThreadPool";
+            throw;
+        }
+    }
+
+    bool Take(Worker* self, Task& task) {
+        {
+            LockGuard<Mutex> guard(self->mutex);
+            if (!self->tasks.empty()) {
+                task = std::move(self->tasks.back());
+                self->tasks.pop_back();
+                self->size = self->tasks.size();
+                return true;
+            }
+        }
+        for (size_t i = 1; i < workers_.size(); ++i) {
+            Worker* victim = workers_[(self->index + i) % workers_.size()].get();
+            if (victim->size.load(std::memory_order_relaxed) == 0) {
+                continue;
+            }
+            LockGuard<Mutex> guard(victim->mutex);
+            if (!victim->tasks.empty()) {
+                task = std::move(victim->tasks.front());
+                victim->tasks.pop_front();
+                victim->size = victim->tasks.size();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // sleeping_ is raised before the deques are rechecked, and submitters
+    // read it after publishing their task, so one of both sides always sees
+    // the other and no wakeup is lost.
+    void Park() {
+        LockGuard<Mutex> guard(mutex_);
+        ++sleeping_;
+        while (running_ && !HasPendingTask()) {
+            idle_.Wait();
+        }
+        --sleeping_;
+    }
+
+    void WakeUpIfSleeping(size_t num) {
+        size_t sleeping = sleeping_.load();
+        if (num > 0 && sleeping > 0) {
+            LockGuard<Mutex> guard(mutex_);
+            if (num >= sleeping) {
+                idle_.NotifyAll();
+            } else {
+                for (size_t i = 0; i < num; ++i) {
+                    idle_.Notify();
+                }
+            }
+        }
+    }
+
+    bool HasPendingTask() const {
+        for (auto& worker : workers_) {
+            if (worker->size.load() > 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::atomic<bool> running_;
+    Mutex mutex_;
+    Condition idle_;
+    std::atomic<size_t> sleeping_;
+    std::atomic<size_t> next_worker_;
+    Task thread_init_callback_;
+    size_t num_threads_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::vector<std::shared_ptr<std::thread>> threads_;
+};
+
+} // namespace arcane
+
+#endif
@@ -0,0 +1,122 @@
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arcane/log.h>
+#include <arcane/channel.h>
+#include <arcane/futex_mutex.h>
+#include <arcane/thread_pool.h>
+
+// numbers -> squares on pool workers -> sum, each arrow a bounded channel
+void test_pipeline() {
+    constexpr const int64_t kNum = 100000;
+    constexpr const size_t kWorkers = 4;
+    arcane::ThreadPool<> pool(kWorkers);
+    pool.start();
+    arcane::Channel<int64_t> numbers(64);
+    arcane::Channel<int64_t, arcane::FutexMutex<>> squares(64);
+    std::atomic<size_t> running(kWorkers);
+    for (size_t i = 0; i < kWorkers; ++i) {
+        pool.RunTask([&numbers, &squares, &running]() {
+            int64_t n = 0;
+            while (numbers.Recv(n)) {
+                squares.Send(n * n);
+            }
+            if (--running == 0) {
+                squares.Close();
+            }
+        });
+    }
+    std::thread producer([&numbers]() {
+        for (int64_t n = 1; n <= kNum; ++n) {
+            numbers.Send(n);
+        }
+        numbers.Close();
+    });
+    int64_t sum = 0;
+    int64_t count = 0;
+    int64_t square = 0;
+    while (squares.Recv(square)) {
+        sum += square;
+        ++count;
+    }
+    producer.join();
+    pool.stop();
+    LOG_INFO << "pipeline count:" << count << " sum:" << sum
+             << " expected:" << kNum * (kNum + 1) * (2 * kNum + 1) / 6;
+}
+
+void test_try_and_close() {
+    arcane::Channel<std::unique_ptr<int>> channel(2);
+    std::unique_ptr<int> value(new int(3));
+    LOG_INFO << "try send:" << channel.TrySend(std::move(value)) << " moved:" << (value == nullptr);
+    channel.Send(std::unique_ptr<int>(new int(4)));
+    value.reset(new int(5));
+    LOG_INFO << "try send full:" << channel.TrySend(std::move(value)) << " kept:" << (value != nullptr);
+    channel.Close();
+    LOG_INFO << "send closed:" << channel.Send(std::move(value));
+    std::unique_ptr<int> out;
+    while (channel.Recv(out)) {
+        LOG_INFO << "drained:" << *out;
+    }
+    LOG_INFO << "try recv closed:" << channel.TryRecv(out);
+}
+
+void test_select() {
+    arcane::Channel<int> a(4);
+    arcane::Channel<std::string> b;
+    arcane::Channel<int> out(1);
+    std::thread sender([&a, &b]() {
+        for (int i = 0; i < 100; ++i) {
+            if (i % 3 == 0) {
+                b.Send(std::to_string(i));
+            } else {
+                a.Send(i);
+            }
+            if (i % 10 == 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+        a.Close();
+        b.Close();
+    });
+    int from_a = 0;
+    int from_b = 0;
+    bool sent = false;
+    arcane::Selector selector;
+    selector.OnRecv(a, [&from_a](int&&) {
+                ++from_a;
+            })
+            .OnRecv(b, [&from_b](std::string&&) {
+                ++from_b;
+            })
+            .OnSend(out, 42, [&sent]() {
+                sent = true;
+            });
+    int selected = 0;
+    while (selector.Select() != arcane::Selector::kAllClosed) {
+        ++selected;
+        if (sent) {
+            out.Close();
+        }
+    }
+    sender.join();
+    int value = 0;
+    LOG_INFO << "select a:" << from_a << " b:" << from_b << " sent:" << sent
+             << " selected:" << selected << " out:" << (out.Recv(value) ? value : -1);
+    LOG_INFO << "try select on closed:" << selector.TrySelect();
+}
+
+int main() {
+    arcane::LogPolicy::GetInstance().Unmute();
+    LOG_INFO << "test start...";
+    test_pipeline();
+    test_try_and_close();
+    test_select();
+    LOG_INFO << "test end...";
+    return 0;
+}
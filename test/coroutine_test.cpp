@@ -0,0 +1,68 @@
+
+#include <string>
+#include <thread>
+#include <chrono>
+
+#include <arcane/log.h>
+#include <arcane/thread_pool.h>
+#include <arcane/work_stealing_thread_pool.h>
+#include <arcane/future.h>
+#include <arcane/coroutine.h>
+#include <arcane/thread_utils.h>
+#include <arcane/coordinate.h>
+#include <arcane/coordinate_calculation.h>
+#include <arcane/coordinate_transform.h>
+
+int accumulate(int low, int high) {
+    int v = 0;
+    for (int i = low; i <= high; ++i) {
+        v += i;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    return v;
+}
+
+template <typename Pool>
+arcane::Task<arcane::Coordinate> transform(Pool& pool, arcane::Coordinate coordinate) {
+    co_await pool.Schedule();
+    LOG_INFO << "transform tid:" << arcane::GetTid();
+    co_return arcane::CoordinateTransform(coordinate, "wgs84", "gcj02").first;
+}
+
+template <typename Pool>
+arcane::Task<double> distance(Pool& pool, arcane::Coordinate a, arcane::Coordinate b) {
+    arcane::Coordinate from = co_await transform(pool, a);
+    arcane::Coordinate to = co_await transform(pool, b);
+    co_return arcane::HaversineDistance(from, to);
+}
+
+template <typename Pool>
+arcane::Task<std::string> pipeline(Pool& pool) {
+    double meters = co_await distance(pool, arcane::Coordinate(116.3, 39.9), arcane::Coordinate(116.4, 39.9));
+    arcane::Future<int, Pool> future(pool, std::bind(accumulate, 1, 100));
+    int sum = co_await future;
+    LOG_INFO << "resumed tid:" << arcane::GetTid();
+    co_return std::to_string(meters) + " " + std::to_string(sum);
+}
+
+template <typename Pool>
+arcane::Task<> noop(Pool& pool) {
+    co_await pool.Schedule();
+}
+
+int main() {
+    arcane::LogPolicy::GetInstance().Unmute();
+    LOG_INFO << "test start... tid:" << arcane::GetTid();
+
+    arcane::ThreadPool<> pool(4);
+    pool.start();
+    LOG_INFO << arcane::SyncWait(pipeline(pool));
+    arcane::SyncWait(noop(pool));
+
+    arcane::WorkStealingThreadPool work_stealing_pool(4);
+    work_stealing_pool.start();
+    LOG_INFO << arcane::SyncWait(pipeline(work_stealing_pool));
+
+    LOG_INFO << "test end...";
+    return 0;
+}
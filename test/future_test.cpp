@@ -1,3 +1,5 @@
+#include <atomic>
+#include <string>
 #include <utility>
 #include <thread>
 #include <chrono>
@@ -5,6 +7,7 @@
 #include <arcane/log.h>
 #include <arcane/future.h>
 #include <arcane/multi_future.h>
+#include <arcane/work_stealing_thread_pool.h>
 #include <arcane/thread_utils.h>
 
 int accumulate(int low, int high) {
@@ -25,6 +28,11 @@ void test() {
     int v = future.Get();
     LOG_INFO << v;
 
+    arcane::Future<int> slow(pool, std::bind(accumulate, 1, 10));
+    std::pair<int, bool> timed = slow.Get(1000);
+    LOG_INFO << "timed out:" << !timed.second;
+    LOG_INFO << slow.Get(2000000).first;
+
     std::vector<arcane::MultiFuture<int>::Task> tasks;
     for (int i = 0; i < 10; ++i) {
         tasks.push_back(std::bind(accumulate, 1, 100 * i));
@@ -36,10 +44,184 @@ void test() {
     }
 }
 
+void test_continuation() {
+    arcane::ThreadPool<> pool(4);
+    pool.start();
+
+    arcane::Future<int> future(pool, std::bind(accumulate, 1, 100));
+    auto twice = future.Then([](int v) {
+        return v * 2;
+    });
+    auto text = twice.Then([](int v) {
+        return std::to_string(v);
+    });
+    LOG_INFO << text.Get();
+
+    std::vector<arcane::Future<int>> futures;
+    for (int i = 1; i <= 3; ++i) {
+        futures.emplace_back(pool, std::bind(accumulate, 1, 100 * i));
+    }
+    auto all = arcane::WhenAll(pool, futures);
+    auto any = arcane::WhenAny(pool, futures);
+    for (int value : all.Get()) {
+        LOG_INFO << value;
+    }
+    std::pair<size_t, int> first = any.Get();
+    LOG_INFO << "first index:" << first.first << " value:" << first.second;
+}
+
+void test_lock_free_queue() {
+    using Pool = arcane::ThreadPool<arcane::BoundedMpmcQueue<arcane::ThreadPoolTask>>;
+    Pool pool(4, 8);
+    pool.start();
+
+    std::vector<arcane::MultiFuture<int, Pool>::Task> tasks;
+    for (int i = 0; i < 20; ++i) {
+        tasks.push_back(std::bind(accumulate, 1, 100 * i));
+    }
+    arcane::MultiFuture<int, Pool> multi_future(pool, tasks);
+    for (int value : multi_future.Get()) {
+        LOG_INFO << value;
+    }
+}
+
+void test_futex_mutex() {
+    using Pool = arcane::ThreadPool<std::deque<arcane::ThreadPoolTask>, arcane::FutexMutex<>>;
+    using MultiFuture = arcane::MultiFuture<int, Pool, arcane::FutexMutex<>>;
+    Pool pool(4, 8);
+    pool.start();
+
+    std::vector<MultiFuture::Task> tasks;
+    for (int i = 0; i < 20; ++i) {
+        tasks.push_back(std::bind(accumulate, 1, 100 * i));
+    }
+    MultiFuture multi_future(pool, tasks);
+    std::pair<std::vector<int>, bool> timed = multi_future.Get(1000);
+    // the expired Get cancelled the tasks still queued, they report 0
+    LOG_INFO << "timed out:" << !timed.second << " cancelled:" << multi_future.IsCancelled();
+    for (int value : multi_future.Get()) {
+        LOG_INFO << value;
+    }
+}
+
+void test_work_stealing() {
+    arcane::WorkStealingThreadPool pool(4);
+    pool.start();
+
+    using Future = arcane::Future<int, arcane::WorkStealingThreadPool>;
+    using MultiFuture = arcane::MultiFuture<int, arcane::WorkStealingThreadPool>;
+
+    Future future(pool, std::bind(accumulate, 1, 100));
+    LOG_INFO << future.Get();
+
+    std::vector<MultiFuture::Task> tasks;
+    for (int i = 0; i < 10; ++i) {
+        tasks.push_back(std::bind(accumulate, 1, 100 * i));
+    }
+    MultiFuture multi_future(pool, tasks);
+    for (int value : multi_future.Get()) {
+        LOG_INFO << value;
+    }
+}
+
+void test_cancellation() {
+    arcane::ThreadPool<> pool(1);
+    pool.start();
+    std::atomic<int> ran(0);
+    auto work = [&ran]() {
+        ++ran;
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        return 1;
+    };
+
+    // the first task occupies the only thread, the second is still queued
+    arcane::Future<int> running(pool, work);
+    arcane::Future<int> queued(pool, work);
+    queued.Cancel();
+    LOG_INFO << "running:" << running.Get() << " queued:" << queued.Get() << " ran:" << ran.load();
+
+    // a task polling its token stops early
+    arcane::Future<int> polling(pool, [](const arcane::CancellationToken& token) {
+        int steps = 0;
+        while (!token.IsCancelled() && steps < 1000) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            ++steps;
+        }
+        return steps;
+    });
+    std::pair<int, bool> timed = polling.Get(20000);
+    LOG_INFO << "polling timed out:" << !timed.second << " steps:" << polling.Get();
+
+    // an expired Get sheds the queued rest of a MultiFuture
+    ran = 0;
+    std::vector<arcane::MultiFuture<int>::Task> tasks(10, work);
+    std::pair<std::vector<int>, bool> result;
+    {
+        arcane::MultiFuture<int> multi_future(pool, tasks);
+        result = multi_future.Get(150000);
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    LOG_INFO << "multi future timed out:" << !result.second << " ran:" << ran.load() << " of 10";
+
+    // one token shared by several futures
+    arcane::CancellationToken token;
+    arcane::Future<int> first(pool, work, token);
+    arcane::Future<int> second(pool, work, token);
+    token.Cancel();
+    LOG_INFO << "shared token first:" << first.Get() << " second:" << second.Get()
+             << " cancelled:" << first.IsCancelled() << second.IsCancelled();
+    pool.stop();
+}
+
+void test_streaming() {
+    arcane::ThreadPool<> pool(4);
+    pool.start();
+    std::vector<arcane::MultiFuture<std::string>::Task> tasks;
+    for (int i = 0; i < 4; ++i) {
+        tasks.push_back([i]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100 * (4 - i)));
+            return "task " + std::to_string(i);
+        });
+    }
+
+    // finished first, handed out first
+    arcane::MultiFuture<std::string> stream(pool, tasks);
+    std::pair<size_t, std::string> next;
+    while (stream.Next(&next)) {
+        LOG_INFO << "streamed index:" << next.first << " value:" << next.second;
+    }
+
+    // answer with what is there at the deadline
+    arcane::MultiFuture<std::string> partial(pool, tasks);
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(250);
+    int64_t remaining = 0;
+    int got = 0;
+    while ((remaining = std::chrono::duration_cast<std::chrono::microseconds>(
+                    deadline - std::chrono::steady_clock::now()).count()) > 0 &&
+           partial.Next(&next, remaining)) {
+        ++got;
+    }
+    partial.Cancel();
+    LOG_INFO << "partial got:" << got << " remaining:" << partial.Remaining();
+
+    arcane::MultiFuture<std::string> taken(pool, tasks);
+    std::vector<std::string> values = taken.Take();
+    LOG_INFO << "taken:" << values.front() << " ... " << values.back();
+    // nothing left to stream once the results were taken
+    LOG_INFO << "after take next:" << taken.Next(&next) << " remaining:" << taken.Remaining();
+    pool.stop();
+}
+
 int main () {
     arcane::LogPolicy::GetInstance().Unmute();
     LOG_INFO << "test start...";
     test();
+    test_continuation();
+    test_lock_free_queue();
+    test_futex_mutex();
+    test_work_stealing();
+    test_cancellation();
+    test_streaming();
     LOG_INFO << "test end...";
     return 0;
 }
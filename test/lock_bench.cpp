@@ -0,0 +1,205 @@
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <arcane/log.h>
+#include <arcane/mutex.h>
+#include <arcane/rwlock.h>
+#include <arcane/distributed_rwlock.h>
+#include <arcane/seqlock.h>
+#include <arcane/spinlock.h>
+#include <arcane/futex_mutex.h>
+#include <arcane/adaptive_mutex.h>
+#include <arcane/lock_guard.h>
+
+namespace {
+
+constexpr const int64_t kIterationsPerThread = 1000000;
+
+// a short critical section, about what Lru::Get or ThreadPool::Take do
+struct Shared {
+    int64_t counter = 0;
+    int64_t values[8] = {0};
+};
+
+} // namespace
+
+template <typename Lock>
+void Bench(const char* name, int num_threads) {
+    Lock lock;
+    Shared shared;
+    std::atomic<bool> go(false);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < num_threads; ++i) {
+        threads.emplace_back([&lock, &shared, &go]() {
+            while (!go) {
+                std::this_thread::yield();
+            }
+            for (int64_t n = 0; n < kIterationsPerThread; ++n) {
+                arcane::LockGuard<Lock> guard(lock);
+                ++shared.counter;
+                shared.values[n & 7] += n;
+            }
+        });
+    }
+    auto begin = std::chrono::steady_clock::now();
+    go = true;
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    auto end = std::chrono::steady_clock::now();
+    int64_t total = kIterationsPerThread * num_threads;
+    LOG_INFO << name << " threads:" << num_threads
+             << " ns per acquisition:"
+             << std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count() / total
+             << (shared.counter == total ? "" : " WRONG COUNT");
+}
+
+// one write every kWritePeriod operations, a writer keeps all values
+// equal so a reader seeing them differ caught a torn update
+constexpr const int64_t kWritePeriod = 1000;
+
+template <typename Lock>
+void BenchReadMostly(const char* name, int num_threads) {
+    Lock lock;
+    Shared shared;
+    std::atomic<bool> go(false);
+    std::atomic<int64_t> torn(0);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < num_threads; ++i) {
+        threads.emplace_back([&lock, &shared, &go, &torn]() {
+            while (!go) {
+                std::this_thread::yield();
+            }
+            for (int64_t n = 0; n < kIterationsPerThread; ++n) {
+                if (n % kWritePeriod == 0) {
+                    arcane::WriteLockGuard guard(lock);
+                    ++shared.counter;
+                    for (auto& value : shared.values) {
+                        value = shared.counter;
+                    }
+                } else {
+                    arcane::ReadLockGuard guard(lock);
+                    if (shared.values[n & 7] != shared.counter) {
+                        ++torn;
+                    }
+                }
+            }
+        });
+    }
+    auto begin = std::chrono::steady_clock::now();
+    go = true;
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    auto end = std::chrono::steady_clock::now();
+    int64_t total = kIterationsPerThread * num_threads;
+    LOG_INFO << name << " read mostly threads:" << num_threads
+             << " ns per acquisition:"
+             << std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count() / total
+             << (torn == 0 ? "" : " TORN READS");
+}
+
+void BenchSeqLock(int num_threads) {
+    arcane::SeqLock<Shared> lock;
+    std::atomic<bool> go(false);
+    std::atomic<int64_t> torn(0);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < num_threads; ++i) {
+        threads.emplace_back([&lock, &go, &torn]() {
+            while (!go) {
+                std::this_thread::yield();
+            }
+            for (int64_t n = 0; n < kIterationsPerThread; ++n) {
+                if (n % kWritePeriod == 0) {
+                    arcane::SeqLockWriteGuard<Shared> guard(lock);
+                    ++guard->counter;
+                    for (auto& value : guard->values) {
+                        value = guard->counter;
+                    }
+                } else {
+                    Shared shared = lock.Load();
+                    if (shared.values[n & 7] != shared.counter) {
+                        ++torn;
+                    }
+                }
+            }
+        });
+    }
+    auto begin = std::chrono::steady_clock::now();
+    go = true;
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    auto end = std::chrono::steady_clock::now();
+    int64_t total = kIterationsPerThread * num_threads;
+    LOG_INFO << "SeqLock read mostly threads:" << num_threads
+             << " ns per acquisition:"
+             << std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count() / total
+             << (torn == 0 && lock.Load().counter == total / kWritePeriod ? "" : " TORN READS");
+}
+
+// releases the lock right before the last spin of a contended Lock, so
+// that the spin takes it
+struct ReleaseOnLastSpin {
+    using Mutex = arcane::AdaptiveMutex<ReleaseOnLastSpin>;
+
+    static void Wait(int32_t) {
+        if (++spins == Mutex::kMinSpins) {
+            mutex->Unlock();
+        }
+    }
+
+    static inline int32_t spins = 0;
+    static inline Mutex* mutex = nullptr;
+};
+
+// a lock taken on the last spin must not park on itself
+void test_adaptive_last_spin() {
+    ReleaseOnLastSpin::Mutex mutex;
+    ReleaseOnLastSpin::mutex = &mutex;
+    mutex.Lock();
+    std::atomic<bool> locked(false);
+    std::thread thread([&mutex, &locked]() {
+        mutex.Lock();
+        locked = true;
+    });
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!locked && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    if (!locked) {
+        LOG_INFO << "AdaptiveMutex taken on the last spin deadlocked";
+        _Exit(1);
+    }
+    thread.join();
+    mutex.Unlock();
+    LOG_INFO << "AdaptiveMutex taken on spin:" << ReleaseOnLastSpin::spins;
+}
+
+void bench() {
+    for (int num_threads : {1, 2, 4, 8}) {
+        Bench<arcane::Mutex>("Mutex", num_threads);
+        Bench<arcane::SpinLock>("SpinLock", num_threads);
+        Bench<arcane::FutexMutex<>>("FutexMutex", num_threads);
+        Bench<arcane::AdaptiveMutex<>>("AdaptiveMutex", num_threads);
+    }
+    for (int num_threads : {1, 2, 4, 8}) {
+        BenchReadMostly<arcane::RWLock>("RWLock", num_threads);
+        BenchReadMostly<arcane::DistributedRWLock>("DistributedRWLock", num_threads);
+        BenchSeqLock(num_threads);
+    }
+}
+
+int main() {
+    arcane::LogPolicy::GetInstance().Unmute();
+    LOG_INFO << "bench start... hardware threads:" << std::thread::hardware_concurrency();
+    test_adaptive_last_spin();
+    bench();
+    LOG_INFO << "bench end...";
+    return 0;
+}
@@ -0,0 +1,122 @@
+#include <stdint.h>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <arcane/log.h>
+#include <arcane/mutex.h>
+#include <arcane/condition.h>
+#include <arcane/spinlock.h>
+#include <arcane/rwlock.h>
+#include <arcane/futex_mutex.h>
+#include <arcane/lock_guard.h>
+#include <arcane/lock_profiler.h>
+
+#ifdef ARCANE_LOCK_PROFILING
+
+namespace {
+
+arcane::Mutex g_hot_mutex;
+arcane::Mutex g_cold_mutex;
+arcane::SpinLock g_spin;
+arcane::RWLock g_rwlock;
+int64_t g_value = 0;
+
+void Busy(int64_t microseconds) {
+    auto end = std::chrono::steady_clock::now() + std::chrono::microseconds(microseconds);
+    while (std::chrono::steady_clock::now() < end) {
+    }
+}
+
+void HotPath() {
+    arcane::LockGuard<arcane::Mutex> guard(g_hot_mutex);
+    Busy(20);
+    ++g_value;
+}
+
+void ColdPath() {
+    arcane::LockGuard<arcane::Mutex> guard(g_cold_mutex);
+    ++g_value;
+}
+
+} // namespace
+
+void test_profile() {
+    arcane::LockProfiler& profiler = arcane::LockProfiler::GetInstance();
+    profiler.Enable();
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i) {
+        threads.emplace_back([]() {
+            for (int n = 0; n < 2000; ++n) {
+                HotPath();
+                if (n % 10 == 0) {
+                    ColdPath();
+                }
+                {
+                    arcane::LockGuard<arcane::SpinLock> guard(g_spin);
+                    ++g_value;
+                }
+                if (n % 100 == 0) {
+                    arcane::WriteLockGuard guard(g_rwlock);
+                    Busy(50);
+                } else {
+                    arcane::ReadLockGuard guard(g_rwlock);
+                    ++n;
+                    --n;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // taken without a guard, and released inside a condition wait
+    g_cold_mutex.Lock();
+    g_cold_mutex.Unlock();
+    {
+        arcane::LockGuard<arcane::Mutex> guard(g_hot_mutex);
+        arcane::Condition cond(g_hot_mutex);
+        cond.TimedWaitMicroseconds(1000);
+    }
+
+    profiler.Dump(3);
+    profiler.Disable();
+    profiler.Reset();
+    HotPath();
+    profiler.Dump(3);
+}
+
+// a guard on a lock the profiler does not know must not leave its site
+// behind for the next lock taken directly, that one is an unknown site
+void test_unprofiled_guard() {
+    arcane::LockProfiler& profiler = arcane::LockProfiler::GetInstance();
+    profiler.Enable();
+    arcane::FutexMutex<> futex_mutex;
+    arcane::Mutex mutex;
+    {
+        arcane::LockGuard<arcane::FutexMutex<>> guard(futex_mutex);
+    }
+    mutex.Lock();
+    mutex.Unlock();
+    mutex.Lock();
+    mutex.Unlock();
+    profiler.Dump(1);
+    profiler.Disable();
+    profiler.Reset();
+}
+
+#endif // ARCANE_LOCK_PROFILING
+
+int main() {
+    arcane::LogPolicy::GetInstance().Unmute();
+    LOG_INFO << "test start...";
+#ifdef ARCANE_LOCK_PROFILING
+    test_profile();
+    test_unprofiled_guard();
+#else
+    LOG_INFO << "built without ARCANE_LOCK_PROFILING, nothing to profile";
+#endif
+    LOG_INFO << "test end...";
+    return 0;
+}
@@ -0,0 +1,417 @@
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <arcane/log.h>
+#include <arcane/lru.h>
+#include <arcane/concurrent_lru.h>
+#include <arcane/flat_lru.h>
+#include <arcane/clock_lru.h>
+#include <arcane/w_tiny_lfu.h>
+#include <arcane/lru_policies.h>
+#include <arcane/distributed_rwlock.h>
+#include <arcane/mutex.h>
+#include <arcane/lock_guard.h>
+
+namespace {
+
+constexpr const int64_t kOperationsPerThread = 200000;
+constexpr const int64_t kKeys = 20000;
+constexpr const size_t kCapacity = 10000;
+
+// Lru behind one global lock, what ConcurrentLru replaces
+class LockedLru {
+public:
+    explicit LockedLru(size_t max_size)
+        : lru_(max_size) {
+    }
+
+    void Put(const int64_t& key, const int64_t& data) {
+        arcane::LockGuard<arcane::Mutex> guard(mutex_);
+        lru_.Put(key, data);
+    }
+
+    std::pair<int64_t, bool> Get(const int64_t& key) {
+        arcane::LockGuard<arcane::Mutex> guard(mutex_);
+        return lru_.Get(key);
+    }
+
+private:
+    arcane::Mutex mutex_;
+    arcane::Lru<int64_t, int64_t> lru_;
+};
+
+// keys drawn with probability proportional to 1 / rank^skew
+class Zipf {
+public:
+    Zipf(int64_t num_keys, double skew)
+        : cdf_(num_keys) {
+        double sum = 0;
+        for (int64_t i = 0; i < num_keys; ++i) {
+            sum += 1.0 / std::pow(static_cast<double>(i + 1), skew);
+            cdf_[i] = sum;
+        }
+        for (auto& p : cdf_) {
+            p /= sum;
+        }
+    }
+
+    // scatters the ranks so that hot keys are not neighbours
+    int64_t Next(std::mt19937_64& random) {
+        double p = std::uniform_real_distribution<double>(0, 1)(random);
+        int64_t rank = std::lower_bound(cdf_.begin(), cdf_.end(), p) - cdf_.begin();
+        return (rank * 7919) % static_cast<int64_t>(cdf_.size());
+    }
+
+private:
+    std::vector<double> cdf_;
+};
+
+// look up, insert on a miss
+template <typename Cache>
+double HitRatio(Cache& cache, const std::vector<int64_t>& trace) {
+    int64_t hits = 0;
+    for (int64_t key : trace) {
+        if (cache.Get(key).second) {
+            ++hits;
+        } else {
+            cache.Put(key, key * 2);
+        }
+    }
+    return static_cast<double>(hits) / trace.size();
+}
+
+} // namespace
+
+void test_lru() {
+    arcane::Lru<int, int> lru(3);
+    lru.Put(1, 10);
+    lru.Put(2, 20);
+    lru.Put(3, 30);
+    // 1 becomes the most recent, 2 is evicted next
+    bool exist = lru.Exist(1);
+    lru.Put(4, 40);
+    LOG_INFO << "lru size:" << lru.Size() << " exist 1:" << exist
+             << " 1:" << lru.Get(1).second << " 2:" << lru.Get(2).second
+             << " 3:" << lru.Get(3).second << " 4:" << lru.Get(4).second;
+}
+
+// one Put for every four lookups, values are always twice the key
+template <typename Cache>
+void Bench(const char* name, Cache& cache, int num_threads) {
+    std::atomic<bool> go(false);
+    std::atomic<int64_t> hits(0);
+    std::atomic<int64_t> wrong(0);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < num_threads; ++i) {
+        threads.emplace_back([&cache, &go, &hits, &wrong, i]() {
+            std::mt19937_64 random(i);
+            int64_t local_hits = 0;
+            while (!go) {
+                std::this_thread::yield();
+            }
+            for (int64_t n = 0; n < kOperationsPerThread; ++n) {
+                int64_t key = static_cast<int64_t>(random() % kKeys);
+                if (n % 5 == 0) {
+                    cache.Put(key, key * 2);
+                    continue;
+                }
+                auto res = cache.Get(key);
+                if (res.second) {
+                    ++local_hits;
+                    if (res.first != key * 2) {
+                        ++wrong;
+                    }
+                }
+            }
+            hits += local_hits;
+        });
+    }
+    auto begin = std::chrono::steady_clock::now();
+    go = true;
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    auto end = std::chrono::steady_clock::now();
+    int64_t total = kOperationsPerThread * num_threads;
+    LOG_INFO << name << " threads:" << num_threads
+             << " ns per operation:"
+             << std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count() / total
+             << " hits:" << hits.load()
+             << (wrong == 0 ? "" : " WRONG VALUE");
+}
+
+void test_concurrent_lru() {
+    arcane::ConcurrentLru<int, int> lru(64, 4);
+    for (int i = 0; i < 1000; ++i) {
+        lru.Put(i, i);
+    }
+    lru.Delete(999);
+    // never more than the requested capacity
+    arcane::ConcurrentLru<int, int> small(10);
+    arcane::ConcurrentLru<int, int> empty(0);
+    for (int i = 0; i < 1000; ++i) {
+        small.Put(i, i);
+        empty.Put(i, i);
+    }
+    // the policy is picked like for Lru
+    arcane::ConcurrentLru<int, int, arcane::WTinyLfuPolicy> lfu(64, 4);
+    for (int i = 0; i < 1000; ++i) {
+        lfu.Put(i, i);
+    }
+    LOG_INFO << "concurrent w-tinylfu size:" << lfu.Size();
+    LOG_INFO << "concurrent lru shards:" << lru.NumShards() << " size:" << lru.Size()
+             << " 999:" << lru.Exist(999) << " 998:" << lru.Exist(998)
+             << " size of 10:" << small.Size() << " shards:" << small.NumShards()
+             << " size of 0:" << empty.Size();
+}
+
+// same operations on both must give the same answers, both are exact LRU
+void test_flat_lru() {
+    arcane::Lru<int64_t, int64_t> lru(kCapacity);
+    arcane::FlatLru<int64_t, int64_t> flat(kCapacity);
+    std::mt19937_64 random(42);
+    int64_t mismatches = 0;
+    for (int64_t n = 0; n < 1000000; ++n) {
+        int64_t key = static_cast<int64_t>(random() % kKeys);
+        switch (random() % 8) {
+        case 0:
+        case 1:
+            lru.Put(key, n);
+            flat.Put(key, n);
+            break;
+        case 2:
+            lru.Delete(key);
+            flat.Delete(key);
+            break;
+        case 3:
+            mismatches += lru.Exist(key) != flat.Exist(key);
+            break;
+        default:
+            mismatches += lru.Get(key) != flat.Get(key);
+            break;
+        }
+    }
+    mismatches += lru.Size() != flat.Size();
+
+    // size 0 stores nothing, a deleted value is released right away
+    arcane::FlatLru<int, int> empty(0);
+    empty.Put(1, 10);
+    mismatches += empty.Size() != 0 || empty.Exist(1);
+    std::shared_ptr<int> value = std::make_shared<int>(1);
+    arcane::FlatLru<int, std::shared_ptr<int>> shared(4);
+    shared.Put(1, value);
+    shared.Delete(1);
+    mismatches += value.use_count() != 1;
+    LOG_INFO << "flat lru size:" << flat.Size() << " mismatches:" << mismatches
+             << " bytes per entry:" << flat.MemoryUsage() / kCapacity;
+
+    auto begin = std::chrono::steady_clock::now();
+    int64_t hits = 0;
+    for (int64_t n = 0; n < 1000000; ++n) {
+        int64_t key = static_cast<int64_t>(random() % kKeys);
+        if (n % 5 == 0) {
+            lru.Put(key, n);
+        } else {
+            hits += lru.Get(key).second;
+        }
+    }
+    auto middle = std::chrono::steady_clock::now();
+    for (int64_t n = 0; n < 1000000; ++n) {
+        int64_t key = static_cast<int64_t>(random() % kKeys);
+        if (n % 5 == 0) {
+            flat.Put(key, n);
+        } else {
+            hits += flat.Get(key).second;
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    LOG_INFO << "ns per operation Lru:"
+             << std::chrono::duration_cast<std::chrono::nanoseconds>(middle - begin).count() / 1000000
+             << " FlatLru:"
+             << std::chrono::duration_cast<std::chrono::nanoseconds>(end - middle).count() / 1000000
+             << " hits:" << hits;
+}
+
+void test_clock_lru() {
+    arcane::ClockLru<int, int> clock(3);
+    clock.Put(1, 10);
+    clock.Put(2, 20);
+    clock.Put(3, 30);
+    // 1 has its reference bit set, the hand passes it and evicts 2
+    bool exist = clock.Exist(1);
+    clock.Put(4, 40);
+    LOG_INFO << "clock lru size:" << clock.Size() << " exist 1:" << exist
+             << " 1:" << clock.Get(1).second << " 2:" << clock.Get(2).second
+             << " 3:" << clock.Get(3).second << " 4:" << clock.Get(4).second;
+
+    // size 0 stores nothing, a deleted value is released right away
+    arcane::ClockLru<int, int> empty(0);
+    empty.Put(1, 10);
+    std::shared_ptr<int> value = std::make_shared<int>(1);
+    arcane::ClockLru<int, std::shared_ptr<int>> shared(4);
+    shared.Put(1, value);
+    shared.Delete(1);
+    LOG_INFO << "clock lru of size 0 size:" << empty.Size() << " 1:" << empty.Exist(1)
+             << " deleted value use count:" << value.use_count();
+
+    Zipf zipf(kKeys * 10, 0.9);
+    std::mt19937_64 random(7);
+    std::vector<int64_t> trace(1000000);
+    for (auto& key : trace) {
+        key = zipf.Next(random);
+    }
+    arcane::Lru<int64_t, int64_t> lru(kCapacity);
+    arcane::ClockLru<int64_t, int64_t> clock_lru(kCapacity);
+    LOG_INFO << "zipf hit ratio Lru:" << HitRatio(lru, trace)
+             << " ClockLru:" << HitRatio(clock_lru, trace);
+}
+
+// a Zipfian point lookup workload with a scan of keys never seen again
+// every 100000 lookups, only point lookups are counted
+std::vector<int64_t> ScanTrace(Zipf& zipf, std::mt19937_64& random, int64_t scan_size) {
+    std::vector<int64_t> trace;
+    int64_t next_scan_key = kKeys * 100;
+    for (int64_t n = 0; n < 1000000; ++n) {
+        if (n % 100000 == 0) {
+            for (int64_t i = 0; i < scan_size; ++i) {
+                trace.push_back(-next_scan_key++);
+            }
+        }
+        trace.push_back(zipf.Next(random));
+    }
+    return trace;
+}
+
+template <typename Cache>
+double PointHitRatio(Cache& cache, const std::vector<int64_t>& trace) {
+    int64_t hits = 0;
+    int64_t lookups = 0;
+    for (int64_t key : trace) {
+        bool hit = cache.Get(key).second;
+        if (!hit) {
+            cache.Put(key, key * 2);
+        }
+        if (key >= 0) {
+            ++lookups;
+            hits += hit;
+        }
+    }
+    return static_cast<double>(hits) / lookups;
+}
+
+void test_w_tiny_lfu() {
+    arcane::Lru<int, int, arcane::WTinyLfuPolicy> lfu(100);
+    for (int i = 0; i < 1000; ++i) {
+        lfu.Put(i, i);
+    }
+    // copies are independent of the original
+    arcane::Lru<int, int, arcane::WTinyLfuPolicy> copy(lfu);
+    copy.Delete(999);
+    LOG_INFO << "w-tinylfu size:" << lfu.Size() << " copy size:" << copy.Size()
+             << " 999:" << lfu.Exist(999) << " copy 999:" << copy.Exist(999);
+
+    Zipf zipf(kKeys * 10, 0.9);
+    std::mt19937_64 random(11);
+    for (int64_t scan_size : {0, 20000, 100000}) {
+        std::vector<int64_t> trace = ScanTrace(zipf, random, scan_size);
+        arcane::Lru<int64_t, int64_t> lru(kCapacity);
+        arcane::Lru<int64_t, int64_t, arcane::WTinyLfuPolicy> w_tiny_lfu(kCapacity);
+        LOG_INFO << "scan size:" << scan_size << " point lookup hit ratio Lru:" << PointHitRatio(lru, trace)
+                 << " WTinyLfu:" << PointHitRatio(w_tiny_lfu, trace);
+    }
+}
+
+// hit ratio of point lookups, -1 if the cache ever held too many entries
+template <typename Policy>
+double PolicyHitRatio(const std::vector<int64_t>& trace) {
+    arcane::Lru<int64_t, int64_t, Policy> cache(kCapacity);
+    int64_t hits = 0;
+    int64_t lookups = 0;
+    for (int64_t key : trace) {
+        bool hit = cache.Get(key).second;
+        if (!hit) {
+            cache.Put(key, key * 2);
+        }
+        if (cache.Size() > kCapacity) {
+            return -1;
+        }
+        if (key >= 0) {
+            ++lookups;
+            hits += hit;
+        }
+    }
+    return static_cast<double>(hits) / lookups;
+}
+
+void LogHitRatios(const char* name, const std::vector<int64_t>& trace) {
+    LOG_INFO << name << " hit ratio Lru:" << PolicyHitRatio<arcane::LruPolicy>(trace)
+             << " Slru:" << PolicyHitRatio<arcane::SlruPolicy>(trace)
+             << " 2Q:" << PolicyHitRatio<arcane::TwoQueuePolicy>(trace)
+             << " Arc:" << PolicyHitRatio<arcane::ArcPolicy>(trace)
+             << " WTinyLfu:" << PolicyHitRatio<arcane::WTinyLfuPolicy>(trace);
+}
+
+void test_policies() {
+    // every policy keeps the value put last and forgets deleted keys
+    int64_t wrong = 0;
+    arcane::Lru<int, int, arcane::SlruPolicy> slru(10);
+    arcane::Lru<int, int, arcane::TwoQueuePolicy> two_queue(10);
+    arcane::Lru<int, int, arcane::ArcPolicy> arc(10);
+    for (int i = 0; i < 100; ++i) {
+        slru.Put(i % 20, i);
+        two_queue.Put(i % 20, i);
+        arc.Put(i % 20, i);
+        wrong += slru.Get(i % 20).first != i;
+        wrong += two_queue.Get(i % 20).first != i;
+        wrong += arc.Get(i % 20).first != i;
+        slru.Delete((i + 1) % 20);
+        two_queue.Delete((i + 1) % 20);
+        arc.Delete((i + 1) % 20);
+        wrong += slru.Exist((i + 1) % 20) + two_queue.Exist((i + 1) % 20) + arc.Exist((i + 1) % 20);
+    }
+    LOG_INFO << "policies wrong answers:" << wrong;
+
+    // synthetic stand-ins for recorded traces: skewed point lookups,
+    // the same with scans, and a loop slightly larger than the cache
+    Zipf zipf(kKeys * 10, 0.9);
+    std::mt19937_64 random(13);
+    std::vector<int64_t> trace = ScanTrace(zipf, random, 0);
+    LogHitRatios("zipf", trace);
+    trace = ScanTrace(zipf, random, 50000);
+    LogHitRatios("zipf with scans", trace);
+    trace.clear();
+    for (int64_t n = 0; n < 1000000; ++n) {
+        trace.push_back(n % (kCapacity + kCapacity / 10));
+    }
+    LogHitRatios("loop", trace);
+}
+
+int main() {
+    arcane::LogPolicy::GetInstance().Unmute();
+    LOG_INFO << "test start...";
+    test_lru();
+    test_concurrent_lru();
+    test_flat_lru();
+    test_clock_lru();
+    test_w_tiny_lfu();
+    test_policies();
+    for (int num_threads : {1, 2, 4, 8}) {
+        LockedLru locked(kCapacity);
+        Bench("locked Lru", locked, num_threads);
+        arcane::ConcurrentLru<int64_t, int64_t> sharded(kCapacity, 32);
+        Bench("ConcurrentLru", sharded, num_threads);
+        arcane::ClockLru<int64_t, int64_t> clock(kCapacity);
+        Bench("ClockLru", clock, num_threads);
+        arcane::ClockLru<int64_t, int64_t, std::hash<int64_t>, arcane::DistributedRWLock> distributed(kCapacity);
+        Bench("ClockLru DistributedRWLock", distributed, num_threads);
+    }
+    LOG_INFO << "test end...";
+    return 0;
+}
@@ -0,0 +1,66 @@
+
+#include <vector>
+#include <numeric>
+
+#include <arcane/log.h>
+#include <arcane/thread_pool.h>
+#include <arcane/work_stealing_thread_pool.h>
+#include <arcane/parallel.h>
+#include <arcane/coordinate.h>
+#include <arcane/coordinate_calculation.h>
+#include <arcane/coordinate_transform.h>
+
+template <typename Pool>
+void test(Pool& pool) {
+    std::vector<arcane::Coordinate> coordinates;
+    for (int i = 0; i < 100000; ++i) {
+        coordinates.emplace_back(116.0 + i * 1e-5, 39.0 + i * 1e-5);
+    }
+    auto begin = coordinates.cbegin();
+    auto end = coordinates.cend();
+
+    // chunks share their last coordinate with the next one
+    double length = arcane::ParallelReduce(pool, begin, end, 1024, 0.0,
+        [end](std::vector<arcane::Coordinate>::const_iterator b,
+              std::vector<arcane::Coordinate>::const_iterator e) {
+            return arcane::GetLength(b, e == end ? e : e + 1, arcane::HaversineDistance);
+        },
+        [](double lhs, double rhs) {
+            return lhs + rhs;
+        });
+    LOG_INFO << "parallel length:" << length
+             << " serial length:" << arcane::GetLength(begin, end, arcane::HaversineDistance);
+
+    std::vector<arcane::Coordinate> transformed(coordinates.size());
+    arcane::ParallelFor(pool, static_cast<size_t>(0), coordinates.size(), 0,
+        [&coordinates, &transformed](size_t b, size_t e) {
+            for (size_t i = b; i < e; ++i) {
+                transformed[i] = arcane::CoordinateTransform(coordinates[i], "wgs84", "gcj02").first;
+            }
+        });
+    LOG_INFO << coordinates.back() << " -> " << transformed.back();
+
+    std::vector<int> values(1000);
+    std::iota(values.begin(), values.end(), 1);
+    int sum = arcane::ParallelReduce(pool, values.begin(), values.end(), 0, 0,
+        [](std::vector<int>::iterator b, std::vector<int>::iterator e) {
+            return std::accumulate(b, e, 0);
+        },
+        [](int lhs, int rhs) {
+            return lhs + rhs;
+        });
+    LOG_INFO << "sum:" << sum;
+}
+
+int main() {
+    arcane::LogPolicy::GetInstance().Unmute();
+    LOG_INFO << "test start...";
+    arcane::ThreadPool<> pool(4);
+    pool.start();
+    test(pool);
+    arcane::WorkStealingThreadPool work_stealing_pool(4);
+    work_stealing_pool.start();
+    test(work_stealing_pool);
+    LOG_INFO << "test end...";
+    return 0;
+}
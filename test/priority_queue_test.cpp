@@ -0,0 +1,129 @@
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arcane/log.h>
+#include <arcane/priority_task_queue.h>
+#include <arcane/thread_pool.h>
+
+namespace {
+
+using Pool = arcane::ThreadPool<arcane::PriorityTaskQueue>;
+
+// keeps the only pool thread busy until released, so that the tasks
+// queued meanwhile are ordered by the queue alone
+class Blocker {
+public:
+    explicit Blocker(Pool& pool)
+        : started_(false),
+          released_(false) {
+        pool.RunTask([this]() {
+            started_ = true;
+            while (!released_) {
+                std::this_thread::yield();
+            }
+        });
+        while (!started_) {
+            std::this_thread::yield();
+        }
+    }
+
+    void Release() {
+        released_ = true;
+    }
+
+private:
+    std::atomic<bool> started_;
+    std::atomic<bool> released_;
+};
+
+void WaitIdle(Pool& pool) {
+    while (pool.QueueSize() != 0) {
+        std::this_thread::yield();
+    }
+    // the last task may still run
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+}
+
+} // namespace
+
+void test_order() {
+    Pool pool(1);
+    pool.start();
+    std::string order;
+    Blocker blocker(pool);
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    pool.RunTask([&order]() { order += 'l'; }, arcane::TaskPriority::kLow);
+    pool.RunTask([&order]() { order += 'n'; });
+    pool.RunTask([&order]() { order += 'h'; }, arcane::TaskPriority::kHigh);
+    pool.RunTask([&order]() { order += 'e'; }, deadline + std::chrono::seconds(1));
+    pool.RunTask([&order]() { order += 'd'; }, deadline);
+    pool.RunTask([&order]() { order += 'H'; }, arcane::TaskPriority::kHigh);
+    blocker.Release();
+    WaitIdle(pool);
+    pool.stop();
+    LOG_INFO << "order:" << order << (order == "dehHnl" ? " ok" : " wrong");
+}
+
+void test_anti_starvation() {
+    Pool pool(1);
+    pool.start();
+    std::vector<int> order;
+    Blocker blocker(pool);
+    pool.RunTask([&order]() { order.push_back(-1); }, arcane::TaskPriority::kLow);
+    for (int i = 0; i < 100; ++i) {
+        pool.RunTask([&order, i]() { order.push_back(i); }, arcane::TaskPriority::kHigh);
+    }
+    blocker.Release();
+    WaitIdle(pool);
+    pool.stop();
+    size_t position = 0;
+    while (position < order.size() && order[position] != -1) {
+        ++position;
+    }
+    LOG_INFO << "low priority task ran at:" << position << " of " << order.size()
+             << (position <= arcane::PriorityTaskQueue::kMaxSkips ? " ok" : " starved");
+}
+
+void test_expired() {
+    Pool pool(1);
+    pool.start();
+    std::atomic<int> ran(0);
+    Blocker blocker(pool);
+    auto now = std::chrono::steady_clock::now();
+    for (int i = 0; i < 10; ++i) {
+        pool.RunTask([&ran]() { ++ran; }, now + std::chrono::milliseconds(1));
+    }
+    for (int i = 0; i < 5; ++i) {
+        pool.RunTask([&ran]() { ++ran; }, now + std::chrono::seconds(10));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    blocker.Release();
+    WaitIdle(pool);
+    LOG_INFO << "deadline tasks ran:" << ran.load() << " dropped:" << pool.NumDroppedTasks();
+    pool.stop();
+
+    // the deadline still applies on a queue that does not order by it
+    arcane::ThreadPool<> fifo(1);
+    fifo.start();
+    fifo.RunTask([]() {}, std::chrono::steady_clock::now() - std::chrono::seconds(1));
+    fifo.RunTask([&ran]() { ++ran; }, std::chrono::steady_clock::now() + std::chrono::seconds(10));
+    while (fifo.QueueSize() != 0) {
+        std::this_thread::yield();
+    }
+    fifo.stop();
+    LOG_INFO << "fifo pool dropped:" << fifo.NumDroppedTasks();
+}
+
+int main() {
+    arcane::LogPolicy::GetInstance().Unmute();
+    LOG_INFO << "test start...";
+    test_order();
+    test_anti_starvation();
+    test_expired();
+    LOG_INFO << "test end...";
+    return 0;
+}
@@ -0,0 +1,168 @@
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <arcane/log.h>
+#include <arcane/rcu.h>
+#include <arcane/rwlock.h>
+#include <arcane/lock_guard.h>
+#include <arcane/thread_pool.h>
+
+namespace {
+
+constexpr const int64_t kAlive = 0x600dcafe;
+constexpr const int64_t kDead = 0xdeadbeef;
+
+std::atomic<int64_t> g_created(0);
+std::atomic<int64_t> g_destroyed(0);
+
+// stands for a table rebuilt from time to time, a reader finding kDead
+// looks at an object destroyed too early
+struct Table {
+    explicit Table(int64_t v)
+        : magic(kAlive),
+          version(v) {
+        for (auto& value : values) {
+            value = v;
+        }
+        ++g_created;
+    }
+
+    ~Table() {
+        magic = kDead;
+        ++g_destroyed;
+    }
+
+    int64_t magic;
+    int64_t version;
+    int64_t values[16];
+};
+
+} // namespace
+
+void test_rcu_ptr() {
+    arcane::ThreadPool<> pool(1);
+    pool.start();
+    arcane::EpochDomain domain;
+    domain.SetReclaimPool(pool);
+    {
+        arcane::RcuPtr<Table> table(new Table(0), domain);
+        std::atomic<bool> running(true);
+        std::atomic<int64_t> reads(0);
+        std::atomic<int64_t> broken(0);
+        std::vector<std::thread> readers;
+        for (int i = 0; i < 4; ++i) {
+            readers.emplace_back([&]() {
+                int64_t last_version = 0;
+                while (running) {
+                    arcane::EpochGuard guard(domain);
+                    Table* t = table.Get();
+                    if (t->magic != kAlive || t->values[15] != t->version || t->version < last_version) {
+                        ++broken;
+                    }
+                    last_version = t->version;
+                    ++reads;
+                }
+            });
+        }
+        for (int64_t version = 1; version <= 20000; ++version) {
+            table.Update(new Table(version));
+            if (version % 1000 == 0) {
+                std::this_thread::yield();
+            }
+        }
+        running = false;
+        for (auto& reader : readers) {
+            reader.join();
+        }
+        domain.Synchronize();
+        domain.Reclaim();
+        LOG_INFO << "reads:" << reads.load() << " broken:" << broken.load()
+                 << " retired left:" << domain.RetiredSize();
+    }
+    pool.stop();
+    LOG_INFO << "created:" << g_created.load() << " destroyed:" << g_destroyed.load();
+}
+
+void test_nested_and_synchronize() {
+    arcane::EpochDomain domain;
+    std::atomic<bool> inside(false);
+    std::atomic<bool> leave(false);
+    std::thread reader([&]() {
+        arcane::EpochGuard outer(domain);
+        {
+            arcane::EpochGuard inner(domain);
+        }
+        inside = true;
+        while (!leave) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+    while (!inside) {
+        std::this_thread::yield();
+    }
+    bool freed = false;
+    domain.Retire([&freed]() {
+        freed = true;
+    });
+    domain.Reclaim();
+    LOG_INFO << "freed while reader inside:" << freed;
+    auto begin = std::chrono::steady_clock::now();
+    std::thread writer([&domain]() {
+        domain.Synchronize();
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    leave = true;
+    writer.join();
+    reader.join();
+    LOG_INFO << "synchronize waited ms:" << std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - begin).count();
+    domain.Reclaim();
+    LOG_INFO << "freed after reader left:" << freed;
+}
+
+template <typename Guard, typename Lock>
+int64_t BenchRead(Lock& lock, int num_threads) {
+    constexpr const int64_t kIterations = 2000000;
+    Table table(1);
+    std::atomic<int64_t> sum(0);
+    std::vector<std::thread> threads;
+    auto begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < num_threads; ++i) {
+        threads.emplace_back([&]() {
+            int64_t local = 0;
+            for (int64_t n = 0; n < kIterations; ++n) {
+                Guard guard(lock);
+                local += table.values[n & 15];
+            }
+            sum += local;
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - begin).count() / (kIterations * num_threads);
+}
+
+void bench_read_side() {
+    arcane::EpochDomain domain;
+    arcane::RWLock rwlock;
+    for (int num_threads : {1, 4}) {
+        LOG_INFO << "threads:" << num_threads
+                 << " ns per read, EpochGuard:" << BenchRead<arcane::EpochGuard>(domain, num_threads)
+                 << " ReadLockGuard:" << BenchRead<arcane::ReadLockGuard<arcane::RWLock>>(rwlock, num_threads);
+    }
+}
+
+int main() {
+    arcane::LogPolicy::GetInstance().Unmute();
+    LOG_INFO << "test start...";
+    test_rcu_ptr();
+    test_nested_and_synchronize();
+    bench_read_side();
+    LOG_INFO << "test end...";
+    return 0;
+}
@@ -0,0 +1,111 @@
+#include <stdint.h>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <arcane/log.h>
+#include <arcane/strand.h>
+#include <arcane/thread_pool.h>
+#include <arcane/work_stealing_thread_pool.h>
+
+namespace {
+
+// per key state, a task finding it busy or out of order caught an overlap
+struct Entity {
+    Entity()
+        : busy(false),
+          next(0),
+          errors(0) {
+    }
+
+    std::atomic<bool> busy;
+    int64_t next;
+    int64_t errors;
+};
+
+void Step(Entity& entity, int64_t seq) {
+    if (entity.busy.exchange(true)) {
+        ++entity.errors;
+    }
+    if (entity.next != seq) {
+        ++entity.errors;
+    }
+    entity.next = seq + 1;
+    entity.busy = false;
+}
+
+} // namespace
+
+template <typename Pool>
+void test_keyed_executor(Pool& pool, const char* name) {
+    constexpr const int kKeys = 64;
+    constexpr const int64_t kTasksPerKey = 2000;
+    std::vector<Entity> entities(kKeys);
+    std::atomic<int64_t> done(0);
+    {
+        arcane::KeyedExecutor<int, Pool> executor(pool);
+        for (int64_t seq = 0; seq < kTasksPerKey; ++seq) {
+            for (int key = 0; key < kKeys; ++key) {
+                executor.Post(key, [&entities, &done, key, seq]() {
+                    Step(entities[key], seq);
+                    ++done;
+                });
+            }
+        }
+        while (done < kKeys * kTasksPerKey) {
+            std::this_thread::yield();
+        }
+        // the last drains may still be erasing their keys
+        while (executor.NumActiveKeys() != 0) {
+            std::this_thread::yield();
+        }
+    }
+    int64_t errors = 0;
+    for (auto& entity : entities) {
+        errors += entity.errors;
+    }
+    LOG_INFO << name << " keyed tasks:" << done.load() << " errors:" << errors;
+}
+
+void test_strand() {
+    arcane::ThreadPool<> pool(4);
+    pool.start();
+    Entity entity;
+    std::atomic<int64_t> done(0);
+    {
+        // destroyed while its tasks are pending
+        arcane::Strand<> strand(pool);
+        for (int64_t seq = 0; seq < 100000; ++seq) {
+            strand.Post([&entity, &done, seq]() {
+                Step(entity, seq);
+                ++done;
+            });
+        }
+    }
+    while (done < 100000) {
+        std::this_thread::yield();
+    }
+    pool.stop();
+    LOG_INFO << "strand tasks:" << done.load() << " errors:" << entity.errors;
+}
+
+int main() {
+    arcane::LogPolicy::GetInstance().Unmute();
+    LOG_INFO << "test start...";
+    test_strand();
+    {
+        arcane::ThreadPool<> pool(4);
+        pool.start();
+        test_keyed_executor(pool, "ThreadPool");
+        pool.stop();
+    }
+    {
+        arcane::WorkStealingThreadPool pool(4);
+        pool.start();
+        test_keyed_executor(pool, "WorkStealingThreadPool");
+        pool.stop();
+    }
+    LOG_INFO << "test end...";
+    return 0;
+}
@@ -0,0 +1,130 @@
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <arcane/log.h>
+#include <arcane/thread_pool.h>
+#include <arcane/timer_wheel.h>
+#include <arcane/thread_utils.h>
+
+using Clock = std::chrono::steady_clock;
+
+int64_t ElapsedMicroseconds(Clock::time_point begin) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - begin).count();
+}
+
+void test_wheel() {
+    arcane::TimerWheel wheel;
+    wheel.start();
+
+    Clock::time_point begin = Clock::now();
+    std::atomic<int> fired(0);
+    std::atomic<int> early(0);
+    // spread over every level of the wheel
+    std::vector<int64_t> delays = {0, 1000, 5000, 300000, 1000000, 2500000};
+    for (int64_t delay : delays) {
+        wheel.RunAfter(delay, [begin, delay, &fired, &early]() {
+            int64_t elapsed = ElapsedMicroseconds(begin);
+            if (elapsed < delay) {
+                ++early;
+            }
+            LOG_INFO << "delay:" << delay << " fired after:" << elapsed;
+            ++fired;
+        });
+    }
+    arcane::TimerId cancelled = wheel.RunAfter(10000, [&fired]() {
+        LOG_ERROR << "cancelled timer fired";
+        ++fired;
+    });
+    LOG_INFO << "cancel:" << wheel.Cancel(cancelled) << " again:" << wheel.Cancel(cancelled);
+
+    std::atomic<int> ticks(0);
+    arcane::TimerId periodic = wheel.RunEvery(100000, [&ticks]() {
+        ++ticks;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(1050));
+    wheel.Cancel(periodic);
+    LOG_INFO << "periodic ticks:" << ticks.load();
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(1600));
+    LOG_INFO << "fired:" << fired.load() << " of " << delays.size() << " early:" << early.load();
+
+    begin = Clock::now();
+    std::vector<arcane::TimerId> ids;
+    ids.reserve(1000000);
+    for (int i = 0; i < 1000000; ++i) {
+        ids.push_back(wheel.RunAfter(60000000 + i, []() {
+        }));
+    }
+    LOG_INFO << "1M inserts in us:" << ElapsedMicroseconds(begin) << " size:" << wheel.Size();
+    begin = Clock::now();
+    for (arcane::TimerId id : ids) {
+        wheel.Cancel(id);
+    }
+    LOG_INFO << "1M cancels in us:" << ElapsedMicroseconds(begin) << " size:" << wheel.Size();
+}
+
+void test_pool() {
+    arcane::ThreadPool<> pool(2);
+    pool.start();
+
+    std::atomic<int> runs(0);
+    pool.RunAfter(200000, [&runs]() {
+        LOG_INFO << "run after 200ms tid:" << arcane::GetTid();
+        ++runs;
+    });
+    arcane::TimerId periodic = pool.RunEvery(50000, [&runs]() {
+        ++runs;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(520));
+    pool.CancelTimer(periodic);
+    LOG_INFO << "pool runs:" << runs.load();
+    pool.stop();
+}
+
+// timers due while the queue is full wait in the wheel, not in the queue
+void test_bounded_pool() {
+    arcane::ThreadPool<> pool(1, 1);
+    pool.start();
+
+    std::atomic<bool> release(false);
+    std::atomic<int> runs(0);
+    pool.RunTask([&release]() {
+        while (!release.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+    pool.RunTask([&runs]() {
+        ++runs;
+    });
+    for (int i = 0; i < 3; ++i) {
+        pool.RunAfter(10000, [&runs]() {
+            ++runs;
+        });
+    }
+    arcane::TimerId cancelled = pool.RunAfter(10000, [&runs]() {
+        runs += 100;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    // still pending, the timer thread is not stuck handing it over
+    bool cancel = pool.CancelTimer(cancelled);
+    release = true;
+    Clock::time_point begin = Clock::now();
+    while (runs.load() < 4 && ElapsedMicroseconds(begin) < 1000000) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    LOG_INFO << "bounded pool cancel:" << cancel << " runs:" << runs.load();
+    pool.stop();
+}
+
+int main() {
+    arcane::LogPolicy::GetInstance().Unmute();
+    LOG_INFO << "test start...";
+    test_wheel();
+    test_pool();
+    test_bounded_pool();
+    LOG_INFO << "test end...";
+    return 0;
+}
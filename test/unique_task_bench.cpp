@@ -0,0 +1,165 @@
+
+#include <stdlib.h>
+#include <new>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <functional>
+#include <vector>
+
+#include <arcane/log.h>
+#include <arcane/thread_pool.h>
+#include <arcane/unique_task.h>
+
+namespace {
+
+std::atomic<size_t> g_allocations(0);
+
+constexpr const size_t kTaskNum = 1000000;
+
+// a capture of 48 bytes, bigger than the inline buffer of std::function
+struct Payload {
+    int64_t values[6];
+};
+
+// timers fired, global as cancelled periodic timers may still run after
+// the bench returned
+std::atomic<size_t> g_fired(0);
+
+} // namespace
+
+void* operator new(size_t size) {
+    ++g_allocations;
+    void* p = malloc(size);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void* p) noexcept {
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    free(p);
+}
+
+template <typename Func>
+void Bench(const char* name, Func func) {
+    size_t allocations = g_allocations.load();
+    auto begin = std::chrono::steady_clock::now();
+    func();
+    auto end = std::chrono::steady_clock::now();
+    allocations = g_allocations.load() - allocations;
+    LOG_INFO << name
+             << ": allocations per task: " << static_cast<double>(allocations) / kTaskNum
+             << ", ns per task: "
+             << std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count() / kTaskNum;
+}
+
+// returns once every task finished, not just left the queue, as the
+// tasks use the counters
+template <typename Pool>
+void RunPool(Pool& pool) {
+    struct Counters {
+        std::atomic<int64_t> sum{0};
+        std::atomic<size_t> done{0};
+    };
+
+    Counters counters;
+    Payload payload = {{1, 2, 3, 4, 5, 6}};
+    for (size_t i = 0; i < kTaskNum; ++i) {
+        pool.Emplace([&counters, payload]() {
+            counters.sum += payload.values[0];
+            ++counters.done;
+        });
+    }
+    while (counters.done.load() < kTaskNum) {
+        std::this_thread::yield();
+    }
+}
+
+// timers in rounds of kTimerBatch, so that after the first round the
+// wheel reuses its nodes and allocations come from the timer path only
+template <typename Pool>
+void RunTimers(Pool& pool, bool periodic) {
+    constexpr const size_t kTimerBatch = 1000;
+    std::vector<arcane::TimerId> ids(kTimerBatch);
+    for (size_t round = 0; round < kTaskNum / kTimerBatch; ++round) {
+        g_fired = 0;
+        for (auto& id : ids) {
+            if (periodic) {
+                id = pool.RunEvery(1000, []() { ++g_fired; });
+            } else {
+                id = pool.RunAfter(0, []() { ++g_fired; });
+            }
+        }
+        while (g_fired.load() < kTimerBatch) {
+            std::this_thread::yield();
+        }
+        if (periodic) {
+            for (auto id : ids) {
+                pool.CancelTimer(id);
+            }
+        }
+    }
+}
+
+void bench() {
+    Payload payload = {{1, 2, 3, 4, 5, 6}};
+    int64_t sum = 0;
+
+    Bench("std::function", [&]() {
+        for (size_t i = 0; i < kTaskNum; ++i) {
+            std::function<void ()> task([&sum, payload]() {
+                sum += payload.values[0];
+            });
+            task();
+        }
+    });
+
+    Bench("UniqueTask", [&]() {
+        for (size_t i = 0; i < kTaskNum; ++i) {
+            arcane::UniqueTask task([&sum, payload]() {
+                sum += payload.values[0];
+            });
+            task();
+        }
+    });
+
+    arcane::ThreadPool<> deque_pool(1, 4096);
+    deque_pool.start();
+    Bench("ThreadPool<std::deque>", [&]() {
+        RunPool(deque_pool);
+    });
+    deque_pool.stop();
+
+    arcane::ThreadPool<arcane::BoundedMpmcQueue<arcane::ThreadPoolTask>> ring_pool(1, 4096);
+    ring_pool.start();
+    Bench("ThreadPool<BoundedMpmcQueue>", [&]() {
+        RunPool(ring_pool);
+    });
+    ring_pool.stop();
+
+    // a ring queue, std::deque allocates blocks as it grows and shrinks
+    arcane::ThreadPool<arcane::BoundedMpmcQueue<arcane::ThreadPoolTask>> timer_pool(1, 4096);
+    timer_pool.start();
+    Bench("ThreadPool::RunAfter", [&]() {
+        RunTimers(timer_pool, false);
+    });
+    Bench("ThreadPool::RunEvery", [&]() {
+        RunTimers(timer_pool, true);
+    });
+    timer_pool.stop();
+
+    LOG_INFO << sum;
+}
+
+int main() {
+    arcane::LogPolicy::GetInstance().Unmute();
+    LOG_INFO << "bench start...";
+    bench();
+    LOG_INFO << "bench end...";
+    return 0;
+}